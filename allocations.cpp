@@ -0,0 +1,137 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include "allocations.hpp"
+
+namespace allocations {
+
+	namespace {
+		struct Counters {
+			std::atomic<std::uint64_t> allocations{ 0 };
+			std::atomic<std::uint64_t> bytes{ 0 };
+			std::atomic<std::uint64_t> frees{ 0 };
+		};
+
+		// constant initialised, so allocations made before main() are counted safely
+		std::array<Counters, scopeCount> counters;
+#ifdef TTT_TRACK_ALLOCATIONS
+		thread_local Scope currentScope = other;
+#endif
+
+		const char* scopeNames[scopeCount] = { "other", "turn", "render", "search", "log" };
+	}
+
+#ifdef TTT_TRACK_ALLOCATIONS
+	namespace detail {
+		void recordAllocation(std::size_t size) {
+			Counters& scope = counters[currentScope];
+			scope.allocations.fetch_add(1, std::memory_order_relaxed);
+			scope.bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		void recordFree() {
+			counters[currentScope].frees.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	ScopeGuard::ScopeGuard(Scope scope) : previous(currentScope) {
+		currentScope = scope;
+	}
+
+	ScopeGuard::~ScopeGuard() {
+		currentScope = previous;
+	}
+#endif
+
+	Counts getCounts(Scope scope) {
+		const Counters& scopeCounters = counters[scope];
+		return {
+			scopeCounters.allocations.load(std::memory_order_relaxed),
+			scopeCounters.bytes.load(std::memory_order_relaxed),
+			scopeCounters.frees.load(std::memory_order_relaxed),
+		};
+	}
+
+	const char* getScopeName(Scope scope) {
+		return scopeNames[scope];
+	}
+
+	void writeReport(std::ostream& out) {
+		if (!enabled) {
+			out << "allocation tracking is off, build with TTT_TRACK_ALLOCATIONS defined to turn it on" << std::endl;
+			return;
+		}
+		out << std::left << std::setw(10) << "scope" << std::right
+			<< std::setw(14) << "allocations" << std::setw(14) << "bytes" << std::setw(14) << "frees" << std::endl;
+		for (int scope = 0; scope < scopeCount; scope++) {
+			Counts counts = getCounts(static_cast<Scope>(scope));
+			out << std::left << std::setw(10) << scopeNames[scope] << std::right
+				<< std::setw(14) << counts.allocations << std::setw(14) << counts.bytes << std::setw(14) << counts.frees << std::endl;
+		}
+	}
+
+	void dumpReport(const std::string& filename) {
+		if (!enabled) {
+			return;
+		}
+		std::ofstream file(filename, std::ios::app);
+		if (file) {
+			writeReport(file);
+		}
+	}
+}
+
+#ifdef TTT_TRACK_ALLOCATIONS
+// over-aligned new and delete are left to the standard library, nothing in the game allocates over-aligned types
+
+void* operator new(std::size_t size) {
+	allocations::detail::recordAllocation(size);
+	if (void* pointer = std::malloc(size ? size : 1)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	allocations::detail::recordAllocation(size);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+	return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept {
+	if (pointer) {
+		allocations::detail::recordFree();
+		std::free(pointer);
+	}
+}
+
+void operator delete[](void* pointer) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+	operator delete(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+	operator delete(pointer);
+}
+#endif
@@ -0,0 +1,71 @@
+#ifndef ALLOCATIONS_HPP
+#define ALLOCATIONS_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+* Heap allocation tracking, compiled in when TTT_TRACK_ALLOCATIONS is defined.
+* The global operator new and delete are replaced with versions that count every allocation against the
+* scope the allocating thread is in. Scopes nest and an allocation only counts for the innermost one.
+* Without TTT_TRACK_ALLOCATIONS the operators are left alone, ScopeGuard compiles to nothing and every count is 0.
+*/
+namespace allocations {
+	enum Scope {
+		other,
+		turn,
+		render,
+		search,
+		log,
+		scopeCount,
+	};
+
+	struct Counts {
+		std::uint64_t allocations;
+		std::uint64_t bytes;
+		std::uint64_t frees;
+	};
+
+#ifdef TTT_TRACK_ALLOCATIONS
+	const bool enabled = true;
+
+	/**
+	* @brief counts allocations made by this thread against scope for as long as it lives
+	*/
+	class ScopeGuard {
+		public:
+			explicit ScopeGuard(Scope scope);
+			~ScopeGuard();
+			ScopeGuard(const ScopeGuard&) = delete;
+			ScopeGuard& operator=(const ScopeGuard&) = delete;
+		private:
+			Scope previous;
+	};
+#else
+	const bool enabled = false;
+
+	class ScopeGuard {
+		public:
+			explicit ScopeGuard(Scope) {}
+			ScopeGuard(const ScopeGuard&) = delete;
+			ScopeGuard& operator=(const ScopeGuard&) = delete;
+	};
+#endif
+
+	/**
+	* @return totals for the scope across all threads since the program started
+	*/
+	Counts getCounts(Scope scope);
+	const char* getScopeName(Scope scope);
+	/**
+	* @brief writes allocations, bytes and frees of every scope, or a note that tracking is compiled out
+	*/
+	void writeReport(std::ostream& out);
+	/**
+	* @brief appends the report to the given file, does nothing if tracking is compiled out
+	*/
+	void dumpReport(const std::string& filename);
+}
+
+#endif
@@ -0,0 +1,165 @@
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "annotator.hpp"
+#include "utils.hpp"
+
+namespace {
+	struct Job {
+		long long index;
+		std::string line;
+	};
+
+	int sign(int value) {
+		return (value > 0) - (value < 0);
+	}
+
+	/**
+	* @return the annotation of one game line, stats gets the moves of both players
+	*/
+	std::string annotateGame(Engine& engine, long long gameNumber, const std::string& line, std::map<std::string, PlayerStats>& stats) {
+		std::istringstream in(line);
+		std::ostringstream out;
+		std::string names[2];
+		in >> names[0] >> names[1];
+		out << "# game " << gameNumber << " " << names[0] << " (X) vs " << names[1] << " (O)\n";
+
+		// parse the whole game first so an invalid record leaves no partial stats behind
+		std::vector<int> squares;
+		std::string token;
+		Board board;
+		char symbol = 'X';
+		while (in >> token) {
+			if (token.size() != 1 || token[0] < '1' || token[0] > '9') {
+				return out.str() + "# invalid move " + token + "\n";
+			}
+			if (board.evaluate() != 0 || !board.isMovesLeft()) {
+				return out.str() + "# moves after the end of the game\n";
+			}
+			if (board.updateBoard(token[0] - '0', symbol) != Board::UpdateStatus::success) {
+				return out.str() + "# square " + token + " is already taken\n";
+			}
+			squares.push_back(token[0] - '0');
+			symbol = (symbol == 'X') ? 'O' : 'X';
+		}
+		if (names[1].empty()) {
+			return out.str() + "# missing player names\n";
+		}
+
+		board = Board();
+		symbol = 'X';
+		for (int squareNum : squares) {
+			std::pair<int, int> played = { (squareNum - 1) / 3, (squareNum - 1) % 3 };
+			SearchResult best = engine.search(board, symbol);
+			int playedScore = played == best.move ? best.score : engine.scoreMove(board, played, symbol);
+
+			// scores are positive for O, so flip them to be from the side of the player who moved
+			int perspective = symbol == 'O' ? 1 : -1;
+			int lost = (best.score - playedScore) * perspective;
+			bool mistake = sign(playedScore * perspective) < sign(best.score * perspective);
+
+			PlayerStats& player = stats[names[symbol == 'X' ? 0 : 1]];
+			player.moves++;
+			player.mistakes += mistake;
+			player.scoreLost += lost;
+
+			out << symbol << " " << squareNum << " best " << utils::getSquareNum(best.move.first, best.move.second)
+				<< " score " << best.score << " played " << playedScore << (mistake ? " mistake" : "") << "\n";
+
+			board.setCell(played.first, played.second, symbol);
+			symbol = (symbol == 'X') ? 'O' : 'X';
+		}
+		return out.str();
+	}
+}
+
+BatchAnnotator::BatchAnnotator(const Engine& engine, int threadCount, std::size_t window)
+	: engine(engine), threadCount(threadCount < 1 ? 1 : threadCount), window(window < 1 ? 1 : window) {}
+
+long long BatchAnnotator::run(std::istream& in, std::ostream& out) {
+	std::mutex mutex;
+	std::condition_variable jobReady;
+	std::condition_variable gameWritten;
+	std::deque<Job> jobs;
+	std::map<long long, std::string> finished;
+	long long nextToWrite = 0;
+	bool endOfInput = false;
+
+	auto work = [&]() {
+		Engine workerEngine(engine);
+		std::map<std::string, PlayerStats> stats;
+		while (true) {
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				jobReady.wait(lock, [&] { return !jobs.empty() || endOfInput; });
+				if (jobs.empty()) {
+					break;
+				}
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+
+			std::string annotation = annotateGame(workerEngine, job.index + 1, job.line, stats);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			finished[job.index] = std::move(annotation);
+			// whoever fills the gap at the front writes every game that was waiting behind it
+			for (auto next = finished.begin(); next != finished.end() && next->first == nextToWrite; next = finished.erase(next)) {
+				out << next->second;
+				nextToWrite++;
+			}
+			gameWritten.notify_all();
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto& entry : stats) {
+			PlayerStats& total = playerStats[entry.first];
+			total.moves += entry.second.moves;
+			total.mistakes += entry.second.mistakes;
+			total.scoreLost += entry.second.scoreLost;
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int i = 0; i < threadCount; i++) {
+		workers.emplace_back(work);
+	}
+
+	long long gameCount = 0;
+	std::string line;
+	while (std::getline(in, line)) {
+		if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(mutex);
+		gameWritten.wait(lock, [&] { return gameCount - nextToWrite < static_cast<long long>(window); });
+		jobs.push_back({ gameCount++, std::move(line) });
+		jobReady.notify_one();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		endOfInput = true;
+	}
+	jobReady.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+	out.flush();
+	return gameCount;
+}
+
+void writePlayerStats(const std::map<std::string, PlayerStats>& stats, std::ostream& out) {
+	out << std::left << std::setw(16) << "player" << std::right
+		<< std::setw(8) << "moves" << std::setw(10) << "mistakes" << std::setw(12) << "score lost" << std::endl;
+	for (const auto& entry : stats) {
+		out << std::left << std::setw(16) << entry.first << std::right
+			<< std::setw(8) << entry.second.moves << std::setw(10) << entry.second.mistakes
+			<< std::setw(12) << entry.second.scoreLost << std::endl;
+	}
+}
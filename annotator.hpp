@@ -0,0 +1,57 @@
+#ifndef ANNOTATOR_HPP
+#define ANNOTATOR_HPP
+
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include "engine.hpp"
+
+/**
+* @brief how one player did over all annotated games
+*/
+struct PlayerStats {
+	int moves = 0;
+	// moves that turned a win into a draw or loss, or a draw into a loss
+	int mistakes = 0;
+	// total score given away against the best move
+	int scoreLost = 0;
+};
+
+/**
+* @brief annotates archived games with the engine's verdict on every move
+* Input has one game per line: the name of the X player, the name of the O player, then the squares (1-9)
+* played in order with X moving first. Blank lines and lines starting with # are skipped.
+* For every move the output gives the best move, its score, the score of the move played and whether the
+* move was a mistake, with games written in input order.
+*
+* Games are read by the calling thread and handed to the workers through a bounded queue. Finished games
+* wait in a reorder buffer until every game before them is written. The reader stops once it is a fixed number
+* of games ahead of the writer, so memory stays the same however long the input is.
+*/
+class BatchAnnotator {
+	public:
+		/**
+		* @param engine, copied into every worker, its artificial delay and logging should be off
+		* @param window, most games read but not yet written
+		*/
+		BatchAnnotator(const Engine& engine, int threadCount, std::size_t window = 1024);
+		/**
+		* @return games annotated
+		*/
+		long long run(std::istream& in, std::ostream& out);
+		const std::map<std::string, PlayerStats>& getPlayerStats() const { return playerStats; }
+	private:
+		Engine engine;
+		int threadCount;
+		std::size_t window;
+		std::map<std::string, PlayerStats> playerStats;
+};
+
+/**
+* @brief writes each player's moves, mistakes and score lost
+*/
+void writePlayerStats(const std::map<std::string, PlayerStats>& stats, std::ostream& out);
+
+#endif
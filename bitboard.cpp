@@ -0,0 +1,152 @@
+#include <bit>
+#include <cstdlib>
+#include "bitboard.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BITBOARD_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+	const int directions[4] = { 1, 16, 17, 15 };
+
+	using Mask = std::array<std::uint64_t, 4>;
+
+	// moves every bit n places towards bit 0, so each cell sees the cell n bits after it
+	Mask shiftDown(const Mask& mask, int n) {
+		Mask result{};
+		int words = n >> 6, bits = n & 63;
+		for (int i = 0; i + words < 4; i++) {
+			result[i] = mask[i + words] >> bits;
+			if (bits != 0 && i + words + 1 < 4) {
+				result[i] |= mask[i + words + 1] << (64 - bits);
+			}
+		}
+		return result;
+	}
+
+	bool hasRunScalar(const std::uint64_t* stones, const std::uint8_t* steps, int stepCount) {
+		for (int direction : directions) {
+			Mask run = { stones[0], stones[1], stones[2], stones[3] };
+			for (int i = 0; i < stepCount; i++) {
+				Mask shifted = shiftDown(run, steps[i] * direction);
+				for (int word = 0; word < 4; word++) {
+					run[word] &= shifted[word];
+				}
+			}
+			if (run[0] | run[1] | run[2] | run[3]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+#ifdef BITBOARD_AVX2
+	// lane i takes lane i + 1 and the top lane is cleared, a shift by 64 bits
+	AVX2_TARGET __m256i shiftDownLane(__m256i mask) {
+		__m256i moved = _mm256_permute4x64_epi64(mask, _MM_SHUFFLE(3, 3, 2, 1));
+		return _mm256_blend_epi32(moved, _mm256_setzero_si256(), 0xC0);
+	}
+
+	AVX2_TARGET __m256i shiftDown(__m256i mask, int n) {
+		for (; n >= 64; n -= 64) {
+			mask = shiftDownLane(mask);
+		}
+		if (n == 0) {
+			return mask;
+		}
+		__m256i low = _mm256_srl_epi64(mask, _mm_cvtsi32_si128(n));
+		__m256i carried = _mm256_sll_epi64(shiftDownLane(mask), _mm_cvtsi32_si128(64 - n));
+		return _mm256_or_si256(low, carried);
+	}
+
+	AVX2_TARGET bool hasRunAvx2(const std::uint64_t* stones, const std::uint8_t* steps, int stepCount) {
+		// an unaligned load, so a BitBoard and the Board holding it need no more than 8 byte alignment
+		__m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stones));
+		// the four directions are independent chains, so they are interleaved rather than tested one by one
+		__m256i runs[4] = { mask, mask, mask, mask };
+		for (int i = 0; i < stepCount; i++) {
+			for (int d = 0; d < 4; d++) {
+				runs[d] = _mm256_and_si256(runs[d], shiftDown(runs[d], steps[i] * directions[d]));
+			}
+		}
+		__m256i any = _mm256_or_si256(_mm256_or_si256(runs[0], runs[1]), _mm256_or_si256(runs[2], runs[3]));
+		return !_mm256_testz_si256(any, any);
+	}
+
+	bool cpuHasAvx2() {
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		// the operating system also has to save the 256 bit registers on a context switch
+		__cpuid(info, 1);
+		bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+		__cpuidex(info, 7, 0);
+		return osSavesYmm && (info[1] & (1 << 5));
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	using HasRun = bool (*)(const std::uint64_t*, const std::uint8_t*, int);
+
+	HasRun chooseBackend() {
+#ifdef BITBOARD_AVX2
+		if (!std::getenv("TTT_SCALAR_BITBOARD") && cpuHasAvx2()) {
+			return hasRunAvx2;
+		}
+#endif
+		return hasRunScalar;
+	}
+
+	const HasRun hasRun = chooseBackend();
+}
+
+BitBoard::BitBoard(int winLength) {
+	winLength = winLength < 1 ? 1 : winLength > maxSize ? maxSize : winLength;
+	for (int length = 1; length < winLength; stepCount++) {
+		int step = length * 2 <= winLength ? length : winLength - length;
+		steps[stepCount] = static_cast<std::uint8_t>(step);
+		length += step;
+	}
+}
+
+bool BitBoard::hasLine(char symbol) const {
+	return hasRun(symbol == 'X' ? x.data() : o.data(), steps.data(), stepCount);
+}
+
+int BitBoard::getStoneCount() const {
+	int count = 0;
+	for (int word = 0; word < 4; word++) {
+		count += std::popcount(x[word] | o[word]);
+	}
+	return count;
+}
+
+int BitBoard::evaluate() const {
+	if (hasLine('O')) {
+		return +10;
+	}
+	if (hasLine('X')) {
+		return -10;
+	}
+	return 0;
+}
+
+const char* BitBoard::getBackendName() {
+#ifdef BITBOARD_AVX2
+	return hasRun == hasRunAvx2 ? "avx2" : "scalar";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,62 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <array>
+#include <cstdint>
+
+/**
+* @brief the stones of each side on a board up to 15x15 as a 256 bit mask, for win checks without a cell loop
+* Cell row, col is bit row * 16 + col, so every row has an empty 16th column after it. A run is found by ANDing
+* the mask with itself shifted along a direction, 1 for rows, 16 for columns, 17 and 15 for the diagonals,
+* doubling the run length each time, so winLength in a row takes about log2(winLength) shifts per direction.
+* The empty column breaks any run that would wrap from one row into the next, so no other edge masks are needed.
+* Uses AVX2 when the CPU has it and plain 64 bit words otherwise, chosen once at startup. Set the environment
+* variable TTT_SCALAR_BITBOARD to always use the plain version.
+*/
+class BitBoard {
+	public:
+		static const int maxSize = 15;
+		explicit BitBoard(int winLength = 3);
+		/**
+		* @param value, 'X', 'O' or ' ' to clear the cell
+		*/
+		void setCell(int row, int col, char value) {
+			int bit = row * rowStride + col;
+			std::uint64_t mask = std::uint64_t(1) << (bit & 63);
+			x[bit >> 6] &= ~mask;
+			o[bit >> 6] &= ~mask;
+			if (value == 'X') x[bit >> 6] |= mask;
+			else if (value == 'O') o[bit >> 6] |= mask;
+		}
+		/**
+		* @return 10 if O has winLength in a row, -10 if X has, 0 otherwise, the same as Board::evaluate()
+		*/
+		int evaluate() const;
+		bool hasLine(char symbol) const;
+		/**
+		* @return 'X', 'O' or ' '
+		*/
+		char getCell(int row, int col) const {
+			int bit = row * rowStride + col;
+			std::uint64_t mask = std::uint64_t(1) << (bit & 63);
+			return (x[bit >> 6] & mask) ? 'X' : (o[bit >> 6] & mask) ? 'O' : ' ';
+		}
+		/**
+		* @return the stones of symbol in bits word * 64 up to word * 64 + 63
+		*/
+		std::uint64_t getStones(char symbol, int word) const { return symbol == 'X' ? x[word] : o[word]; }
+		int getStoneCount() const;
+		/**
+		* @return "avx2" or "scalar", the win check this process uses
+		*/
+		static const char* getBackendName();
+	private:
+		static const int rowStride = 16;
+		// run lengths added one after the other to get from 1 to winLength, each at most the length so far
+		std::array<std::uint8_t, 5> steps{};
+		int stepCount = 0;
+		std::array<std::uint64_t, 4> x{};
+		std::array<std::uint64_t, 4> o{};
+};
+
+#endif
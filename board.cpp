@@ -1,17 +1,59 @@
 #include <iostream>
+#include <algorithm>
 #include <array>
+#include <cstdio>
 #include <string>
 #include "board.hpp"
 #include "utils.hpp"
 
-Board::Board() : updateStatus(notUpdated) {
-	for (auto &row : grid) {
-		row.fill(' ');
-	}
+namespace {
+    std::uint64_t splitMix64(std::uint64_t& state) {
+        std::uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    // one random key per cell and symbol, plus one per board size and win length
+    const std::array<std::uint64_t, Board::maxSize * Board::maxSize * 2 + (Board::maxSize + 1) * (Board::maxSize + 1)> zobristKeys = [] {
+        std::array<std::uint64_t, Board::maxSize * Board::maxSize * 2 + (Board::maxSize + 1) * (Board::maxSize + 1)> keys{};
+        std::uint64_t state = 0x7469632D7461632DULL;
+        for (auto& key : keys) {
+            key = splitMix64(state);
+        }
+        return keys;
+    }();
+}
+
+Board::Board() : updateStatus(notUpdated), zobrist(dimensionKey(3, 3)) {
     //setCell(5, 'O');
 }
 
-Board::Board(const std::array<std::array<char, 3>, 3> &initialBoard) : updateStatus(notUpdated), grid(initialBoard) {}
+Board::Board(const std::array<std::array<char, 3>, 3> &initialBoard) : Board() {
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            setCell(row, col, initialBoard[row][col]);
+        }
+    }
+}
+
+Board::Board(int size, int winLength) : Board() {
+    this->size = size < 1 ? 1 : size > maxSize ? maxSize : size;
+    this->winLength = winLength < 1 ? 1 : winLength > this->size ? this->size : winLength;
+    zobrist = dimensionKey(this->size, this->winLength);
+    stones = BitBoard(this->winLength);
+}
+
+std::uint64_t Board::cellKey(int row, int col, char value) {
+    if (value != 'X' && value != 'O') {
+        return 0;
+    }
+    return zobristKeys[(row * maxSize + col) * 2 + (value == 'O' ? 1 : 0)];
+}
+
+std::uint64_t Board::dimensionKey(int size, int winLength) {
+    return zobristKeys[maxSize * maxSize * 2 + size * (maxSize + 1) + winLength];
+}
 /*
 void Board::print() {
     const std::string grey = "\033[38;2;80;80;80m";
@@ -62,85 +104,101 @@ void Board::printExampleBoard() {
 }
 */
 int Board::isMovesLeft() const {
-	for (auto& row : grid) {
-        for (auto &cell : row) {
-            if (cell == ' ') {
-                return true;
-            }
-        }
-    }
-    return false;
+    return stones.getStoneCount() < size * size;
 }
 
 char Board::getCell(int row, int col) const {
-    return grid[row][col];
+    return stones.getCell(row, col);
 }
 
 char Board::getCell(int index) const {
-	int row = index / grid.size() + 1; // not sure if the + 1 is correct here
-    int col = index % grid.size() + 1;
-    return grid[row][col];
+	int row = index / maxSize + 1; // not sure if the + 1 is correct here
+    int col = index % maxSize + 1;
+    return stones.getCell(row, col);
 }
 
 void Board::setCell(int row, int col, char value) {
-    grid[row][col] = value;
+    zobrist ^= cellKey(row, col, stones.getCell(row, col)) ^ cellKey(row, col, value);
+    stones.setCell(row, col, value);
 }
 
 void Board::setCell(int squareNum, char value) {
-	std::pair<int, int> position = utils::getPair(squareNum);
-    grid[position.first][position.second] = value;
+    setCell((squareNum - 1) / size, (squareNum - 1) % size, value);
 }
 
 Board::UpdateStatus Board::updateBoard(int squareNum, char value) {
-    std::pair<int, int> position = utils::getPair(squareNum);
-    int row = position.first;
-    int col = position.second;
-    if (squareNum < 1 || squareNum > 9 || isalpha(squareNum)) {
+    if (squareNum < 1 || squareNum > size * size || isalpha(squareNum)) {
         return failInvalidInput;
     }
-    if (grid[row][col] != ' ') {
+    int row = (squareNum - 1) / size;
+    int col = (squareNum - 1) % size;
+    if (getCell(row, col) != ' ') {
         return failSpaceOccupied;
     }
-    grid[row][col] = value;
+    setCell(row, col, value);
     return success;
 }
 
-void Board::handleError(Board::UpdateStatus updateStatus, int squareNum, std::string* errorMessage) {
+std::string_view Board::handleError(Board::UpdateStatus updateStatus, int squareNum, char* buffer, std::size_t bufferSize) const {
     if (updateStatus == Board::UpdateStatus::failSpaceOccupied) {
-        *errorMessage = std::to_string(squareNum) + " is already taken!";
+        int length = std::snprintf(buffer, bufferSize, "%d is already taken!", squareNum);
+        return std::string_view(buffer, length < 0 ? 0 : std::min(static_cast<std::size_t>(length), bufferSize - 1));
     }
     else if (updateStatus == Board::UpdateStatus::failInvalidInput) {
-        *errorMessage = "Please enter a single digit from 1 to 9.";
+        return "Please enter a single digit from 1 to 9.";
     }
     else {
-        *errorMessage = "Some unknown error occurred. :(";
+        return "Some unknown error occurred. :(";
     }
 }
 
 int Board::evaluate() const {
-    for (int row = 0; row < 3; row++) {
-        if (getCell(row, 0) != ' ' &&
-            getCell(row, 0) == getCell(row, 1) &&
-            getCell(row, 1) == getCell(row, 2)) {
-            return getCell(row, 0) == 'O' ? +10 : -10;
-        }
+    if (size == 3 && winLength == 3) {
+        return evaluateThreeByThree();
     }
-    for (int col = 0; col < 3; col++) {
-        if (getCell(0, col) != ' ' &&
-            getCell(0, col) == getCell(1, col) &&
-            getCell(1, col) == getCell(2, col)) {
-            return getCell(0, col) == 'O' ? +10 : -10;
-        }
+    return stones.evaluate();
+}
+
+bool Board::isWinningMove(int row, int col) const {
+    const char value = getCell(row, col);
+    if (value == ' ') {
+        return false;
     }
-    if (getCell(0, 0) != ' ' &&
-        getCell(0, 0) == getCell(1, 1) &&
-        getCell(1, 1) == getCell(2, 2)) {
-        return getCell(0, 0) == 'O' ? +10 : -10;
+    const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+    for (const auto& direction : directions) {
+        int count = 1;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int r = row + sign * direction[0];
+            int c = col + sign * direction[1];
+            while (r >= 0 && r < size && c >= 0 && c < size && getCell(r, c) == value) {
+                count++;
+                r += sign * direction[0];
+                c += sign * direction[1];
+            }
+        }
+        if (count >= winLength) {
+            return true;
+        }
     }
-    if (getCell(0, 2) != ' ' &&
-        getCell(0, 2) == getCell(1, 1) &&
-        getCell(1, 1) == getCell(2, 0)) {
-        return getCell(0, 2) == 'O' ? +10 : -10;
+    return false;
+}
+
+int Board::evaluateThreeByThree() const {
+    // the rows, the columns and the two diagonals, as bits row * 16 + col of the BitBoard's first word
+    static const std::uint64_t lines[8] = {
+        0x7, 0x70000, 0x700000000,
+        0x100010001, 0x200020002, 0x400040004,
+        0x400020001, 0x100020004,
+    };
+    const std::uint64_t x = stones.getStones('X', 0);
+    const std::uint64_t o = stones.getStones('O', 0);
+    for (std::uint64_t line : lines) {
+        if ((o & line) == line) {
+            return +10;
+        }
+        if ((x & line) == line) {
+            return -10;
+        }
     }
 
     return 0;
@@ -148,23 +206,51 @@ int Board::evaluate() const {
 
 std::string Board::toString(bool includeLabels) const {
     std::string result;
-    for (int row = 0; row < 3; row++) {
-        for (int col = 0; col < 3; col++) {
-            result += " ";
-            if (grid[row][col] == ' ') {
-				result += includeLabels ? std::to_string(row * 3 + col + 1) : " ";
+    std::string separator;
+    for (int col = 0; col < size; col++) {
+        separator += (col < size - 1) ? "---+" : "---\n";
+    }
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            std::string cell = " ";
+            char value = getCell(row, col);
+            if (value == ' ') {
+				cell = includeLabels ? std::to_string(row * size + col + 1) : " ";
             } else {
-                result += grid[row][col];
+                cell = value;
             }
-            result += " ";
-            if (col < 2) {
+            result += cell.length() < 2 ? " " + cell + " " : cell.length() < 3 ? " " + cell : cell;
+            if (col < size - 1) {
                 result += "|";
             }
         }
         result += "\n";
-        if (row < 2) {
-            result += "---+---+---\n";
+        if (row < size - 1) {
+            result += separator;
         }
     }
     return result;
+}
+
+int Board::toCode() const {
+    int code = 0;
+    for (int row = 2; row >= 0; row--) {
+        for (int col = 2; col >= 0; col--) {
+            char value = getCell(row, col);
+            code = code * 3 + (value == 'X' ? 1 : value == 'O' ? 2 : 0);
+        }
+    }
+    return code;
+}
+
+Board Board::fromCode(int code) {
+    Board board;
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            int digit = code % 3;
+            board.setCell(row, col, digit == 1 ? 'X' : digit == 2 ? 'O' : ' ');
+            code /= 3;
+        }
+    }
+    return board;
 }
\ No newline at end of file
@@ -2,12 +2,20 @@
 #define BOARD_HPP
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include "bitboard.hpp"
 
 class Board {
     public:
         Board();
 	    Board(const std::array<std::array<char, 3>, 3> &initialBoard);
+        /**
+        * @brief an empty size x size board where winLength in a row wins
+        */
+        Board(int size, int winLength);
         //void print();
 	    //void printExampleBoard();
         char getCell(int row, int col) const;
@@ -15,10 +23,22 @@ class Board {
 	    int isMovesLeft() const;
         /**
         * @brief evaluate() determines the state of the game for the given board
-        * @param board, reference to 2D array representing 3x3 game board
+        * A 3x3 board tests its eight lines as masks, other boards look for runs with a few shifts per direction.
         * @return 10 if the board is a win for O, -10 if it is a win for X, 0 otherwise
         */
         int evaluate() const;
+        /**
+        * @brief checks only the lines through one cell, which is all that can change when a stone is placed there
+        * @return true if the stone at row, col is part of winLength in a row
+        */
+        bool isWinningMove(int row, int col) const;
+        int getSize() const { return size; }
+        int getWinLength() const { return winLength; }
+        /**
+        * @return Zobrist hash of the stones and the board dimensions, kept up to date on every move
+        */
+        std::uint64_t hash() const { return zobrist; }
+        static const int maxSize = 15;
         enum UpdateStatus {
             notUpdated,
             success,
@@ -28,12 +48,29 @@ class Board {
         };
 		UpdateStatus updateBoard(int squareNum, char value);
 		UpdateStatus updateStatus = notUpdated;
-        void handleError(Board::UpdateStatus updateStatus, int squareNum, std::string* errorMessage);
+        /**
+        * @brief the message for a failed updateBoard(), formatted into buffer when it names the square
+        * @return a view of buffer or of a string literal, so reporting an error allocates nothing
+        */
+        std::string_view handleError(Board::UpdateStatus updateStatus, int squareNum, char* buffer, std::size_t bufferSize) const;
         void setCell(int row, int col, char value);
 	    void setCell(int squareNum, char value);
 		std::string toString(bool includeLabels) const;
+		/**
+		* @return base 3 code of a 3x3 board, where an empty square is 0, X is 1 and O is 2 and square 1 is the lowest digit
+		*/
+		int toCode() const;
+		static Board fromCode(int code);
+		static const int codeCount = 19683;
     private:
-        std::array<std::array<char, 3>, 3> grid{ {} };
+        static std::uint64_t cellKey(int row, int col, char value);
+        static std::uint64_t dimensionKey(int size, int winLength);
+        int evaluateThreeByThree() const;
+        int size = 3;
+        int winLength = 3;
+        std::uint64_t zobrist = 0;
+        // the only copy of the stones, two bits a cell whatever the size, so a Board stays small enough to copy
+        BitBoard stones;
 };
 
 #endif
\ No newline at end of file
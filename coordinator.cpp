@@ -0,0 +1,281 @@
+#include <iostream>
+#include "coordinator.hpp"
+
+#ifdef _WIN32
+
+int runShardedSelfPlay(int shardCount, std::uint32_t gamesPerShard, const std::string& recordsFile, int maxRestarts) {
+	std::cerr << "Sharded self-play forks worker processes and is not supported on Windows." << std::endl;
+	return 1;
+}
+
+#else
+
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "board.hpp"
+#include "engine.hpp"
+#include "profiler.hpp"
+#include "utils.hpp"
+
+namespace {
+	// percentage of moves played at random, as in the spectator, so games are not all the same draw
+	const int blunderChance = 10;
+
+	struct Shard {
+		int index;
+		pid_t pid = -1;
+		int fd = -1;
+		// the first game the coordinator has no record of, a restarted worker starts here
+		std::uint32_t nextGame = 0;
+		int restarts = 0;
+		bool finished = false;
+		bool failed = false;
+		std::vector<char> pending;
+	};
+
+	bool writeAll(int fd, const void* data, std::size_t size) {
+		const char* bytes = static_cast<const char*>(data);
+		while (size > 0) {
+			ssize_t written = write(fd, bytes, size);
+			if (written < 0 && errno == EINTR) {
+				continue;
+			}
+			if (written <= 0) {
+				return false;
+			}
+			bytes += written;
+			size -= static_cast<std::size_t>(written);
+		}
+		return true;
+	}
+
+	void pinToCores(int shardIndex, int shardCount) {
+#ifdef __linux__
+		int cores = static_cast<int>(std::thread::hardware_concurrency());
+		int coresPerShard = cores / shardCount > 0 ? cores / shardCount : 1;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (int core = 0; core < coresPerShard; core++) {
+			CPU_SET((shardIndex * coresPerShard + core) % (cores > 0 ? cores : 1), &set);
+		}
+		sched_setaffinity(0, sizeof(set), &set);
+#endif
+	}
+
+	/**
+	* @brief the worker process, plays games firstGame up to gameCount of the shard and writes a record for each
+	*/
+	void playShard(int shardIndex, std::uint32_t firstGame, std::uint32_t gameCount, int fd) {
+		Engine engine(0, false);
+		for (std::uint32_t game = firstGame; game < gameCount; game++) {
+			// every game has its own seed, so a resumed shard replays exactly the games it lost
+			std::mt19937_64 rng((static_cast<std::uint64_t>(shardIndex) << 32) | game);
+			std::uniform_int_distribution<int> randomSquare(1, 9);
+			std::uniform_int_distribution<int> percent(0, 99);
+
+			ShardGameRecord record{};
+			record.gameIndex = game;
+			Board board;
+			char symbol = 'X';
+			while (board.evaluate() == 0 && board.isMovesLeft()) {
+				auto startTime = std::chrono::steady_clock::now();
+				int squareNum;
+				if (record.moveCount == 0 || percent(rng) < blunderChance) {
+					do {
+						squareNum = randomSquare(rng);
+					} while (board.updateBoard(squareNum, symbol) != Board::UpdateStatus::success);
+				}
+				else {
+					std::pair<int, int> move = engine.findBestMove(board, symbol);
+					squareNum = utils::getSquareNum(move.first, move.second);
+					board.setCell(move.first, move.second, symbol);
+				}
+				auto elapsed = std::chrono::steady_clock::now() - startTime;
+
+				record.moveNanoseconds[record.moveCount] = static_cast<std::uint32_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+				record.squares[record.moveCount++] = static_cast<std::uint8_t>(squareNum);
+				symbol = (symbol == 'X') ? 'O' : 'X';
+			}
+			int eval = board.evaluate();
+			record.winner = eval == +10 ? 'O' : eval == -10 ? 'X' : 'T';
+
+			if (!writeAll(fd, &record, sizeof(record))) {
+				return;
+			}
+		}
+		ShardGameRecord done{};
+		done.gameIndex = ShardGameRecord::doneMarker;
+		writeAll(fd, &done, sizeof(done));
+	}
+
+	bool spawn(Shard& shard, std::vector<Shard>& shards, std::uint32_t gamesPerShard) {
+		int fds[2];
+		if (pipe(fds) != 0) {
+			return false;
+		}
+		std::cout.flush();
+		pid_t pid = fork();
+		if (pid < 0) {
+			close(fds[0]);
+			close(fds[1]);
+			return false;
+		}
+		if (pid == 0) {
+			close(fds[0]);
+			for (const Shard& other : shards) {
+				if (other.fd >= 0) {
+					close(other.fd);
+				}
+			}
+			pinToCores(shard.index, static_cast<int>(shards.size()));
+			playShard(shard.index, shard.nextGame, gamesPerShard, fds[1]);
+			close(fds[1]);
+			_exit(0);
+		}
+		close(fds[1]);
+		shard.pid = pid;
+		shard.fd = fds[0];
+		shard.pending.clear();
+		return true;
+	}
+}
+
+int runShardedSelfPlay(int shardCount, std::uint32_t gamesPerShard, const std::string& recordsFile, int maxRestarts) {
+	if (shardCount < 1) {
+		shardCount = 1;
+	}
+	std::ofstream records(recordsFile, std::ios::app);
+	if (!records) {
+		std::cerr << "Could not write " << recordsFile << std::endl;
+		return 1;
+	}
+
+	std::vector<Shard> shards(shardCount);
+	for (int i = 0; i < shardCount; i++) {
+		shards[i].index = i;
+	}
+
+	long long xWins = 0, oWins = 0, ties = 0;
+	profiler::Histogram moveLatency;
+	auto startTime = std::chrono::steady_clock::now();
+
+	for (Shard& shard : shards) {
+		if (!spawn(shard, shards, gamesPerShard)) {
+			std::cerr << "Could not start shard " << shard.index << ": " << std::strerror(errno) << std::endl;
+			shard.failed = true;
+		}
+	}
+
+	while (true) {
+		std::vector<pollfd> polled;
+		std::vector<Shard*> polledShards;
+		for (Shard& shard : shards) {
+			if (shard.fd >= 0) {
+				polled.push_back({ shard.fd, POLLIN, 0 });
+				polledShards.push_back(&shard);
+			}
+		}
+		if (polled.empty()) {
+			break;
+		}
+		if (poll(polled.data(), polled.size(), -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		for (std::size_t i = 0; i < polled.size(); i++) {
+			if (!(polled[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+				continue;
+			}
+			Shard& shard = *polledShards[i];
+			char buffer[sizeof(ShardGameRecord) * 64];
+			ssize_t received = read(shard.fd, buffer, sizeof(buffer));
+			if (received < 0 && errno == EINTR) {
+				continue;
+			}
+
+			if (received > 0) {
+				shard.pending.insert(shard.pending.end(), buffer, buffer + received);
+				std::size_t offset = 0;
+				for (; offset + sizeof(ShardGameRecord) <= shard.pending.size(); offset += sizeof(ShardGameRecord)) {
+					ShardGameRecord record;
+					std::memcpy(&record, shard.pending.data() + offset, sizeof(record));
+					if (record.gameIndex == ShardGameRecord::doneMarker) {
+						shard.finished = true;
+						continue;
+					}
+
+					if (record.winner == 'X') xWins++;
+					else if (record.winner == 'O') oWins++;
+					else ties++;
+					records << "engine engine";
+					for (int move = 0; move < record.moveCount && move < 9; move++) {
+						records << " " << static_cast<int>(record.squares[move]);
+						moveLatency.record(record.moveNanoseconds[move]);
+					}
+					records << "\n";
+					shard.nextGame = record.gameIndex + 1;
+				}
+				shard.pending.erase(shard.pending.begin(), shard.pending.begin() + offset);
+				continue;
+			}
+
+			// end of the pipe, the worker has exited one way or another
+			close(shard.fd);
+			shard.fd = -1;
+			int status = 0;
+			waitpid(shard.pid, &status, 0);
+			bool exitedCleanly = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+			if (shard.finished && exitedCleanly) {
+				continue;
+			}
+
+			shard.finished = false;
+			if (shard.restarts >= maxRestarts) {
+				std::cerr << "Shard " << shard.index << " failed " << shard.restarts + 1 << " times, giving up at game "
+					<< shard.nextGame << std::endl;
+				shard.failed = true;
+				continue;
+			}
+			shard.restarts++;
+			std::cerr << "Shard " << shard.index << " stopped at game " << shard.nextGame << ", restarting it" << std::endl;
+			if (!spawn(shard, shards, gamesPerShard)) {
+				shard.failed = true;
+			}
+		}
+	}
+	records.flush();
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	long long games = xWins + oWins + ties;
+	int failedShards = 0, restarts = 0;
+	for (const Shard& shard : shards) {
+		failedShards += shard.failed;
+		restarts += shard.restarts;
+	}
+
+	std::cout << games << " games in " << shardCount << " shards: " << xWins << " X wins, " << oWins << " O wins, "
+		<< ties << " ties in " << static_cast<long>(elapsed * 1000) << " ms ("
+		<< static_cast<long>(elapsed > 0 ? games / elapsed : 0) << " games/s)" << std::endl;
+	std::cout << "move latency (us): p50 " << std::fixed << std::setprecision(1) << moveLatency.getPercentile(50) / 1000.0
+		<< "  p90 " << moveLatency.getPercentile(90) / 1000.0
+		<< "  p99 " << moveLatency.getPercentile(99) / 1000.0
+		<< "  max " << moveLatency.getMax() / 1000.0 << std::endl;
+	std::cout << restarts << " restarts, " << failedShards << " failed shards, games appended to " << recordsFile << std::endl;
+	return failedShards == 0 ? 0 : 1;
+}
+
+#endif
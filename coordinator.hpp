@@ -0,0 +1,37 @@
+#ifndef COORDINATOR_HPP
+#define COORDINATOR_HPP
+
+#include <cstdint>
+#include <string>
+
+/**
+* @brief one finished game as a worker process sends it to the coordinator, 52 bytes on the pipe
+*/
+struct ShardGameRecord {
+	// index of the game within its shard, doneMarker once the shard has played every game
+	std::uint32_t gameIndex;
+	// 'X' or 'O' for the winner, 'T' for a tie
+	char winner;
+	std::uint8_t moveCount;
+	// squares (1-9) in the order they were played, X first
+	std::uint8_t squares[9];
+	std::uint8_t padding;
+	std::uint32_t moveNanoseconds[9];
+	static const std::uint32_t doneMarker = 0xFFFFFFFF;
+};
+
+/**
+* @brief plays engine self-play games in shardCount forked worker processes and merges their results
+* Each shard plays its own range of game seeds, pinned to its own slice of cores on Linux. Every game is
+* perfect Engine play from a random first move with occasional random blunders, and is fully determined by
+* its seed. Workers stream a ShardGameRecord per game back over a pipe. When a worker dies the coordinator
+* forks a new one that resumes the shard from the first game it has no record of, so a crash only costs the
+* game in progress. The coordinator merges outcome counts and move latency histograms into one report and
+* appends every game to recordsFile in the format read by BatchAnnotator.
+* Needs fork(), so it only reports that it is unsupported on Windows.
+* @param maxRestarts, how often one shard may be restarted before the run gives up on it
+* @return 0 if every shard finished, 1 otherwise
+*/
+int runShardedSelfPlay(int shardCount, std::uint32_t gamesPerShard, const std::string& recordsFile, int maxRestarts = 3);
+
+#endif
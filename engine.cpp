@@ -1,75 +1,384 @@
+#include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <thread>
 #include <chrono>
+#include "allocations.hpp"
 #include "utils.hpp"
 #include "engine.hpp"
+#include "tracer.hpp"
 
-Engine::Engine() {}
+namespace {
+    // depth stored with scores from a search that ran to the end of the game
+    const int solvedDepth = 255;
 
-int Engine::minimax(Board board, bool isMax, int depth) {
-    int score = board.evaluate();
+    // what a win is worth once leaves can have heuristic scores
+    const int heuristicWinScore = 2 * LineEvaluator::maxScore;
+
+    // table entries hold scores as if the position were the root, so they can be reused at any depth.
+    // Only wins depend on the depth, a score no larger than winFloor in size is stored as it is
+    int toStoredScore(int score, int depth, int winFloor) {
+        return score > winFloor ? score + depth : score < -winFloor ? score - depth : score;
+    }
+
+    int fromStoredScore(int score, int depth, int winFloor) {
+        return score > winFloor ? score - depth : score < -winFloor ? score + depth : score;
+    }
+
+    // set in the keys of depth-limited results, so they never answer for a solved position or the other way round
+    const std::uint64_t heuristicKey = 0xD1B54A32D192ED03ULL;
+
+    // plies a search of the unbounded board goes to when no limit is set, and the most a timed one goes to
+    const int sparseDepth = 3;
+    const int maxSparseDepth = 32;
+    // moves searched at each node below the root of the unbounded board, a forced move always rates highest
+    const int sparseBranching = 12;
+    // nodes between two reads of the clock in a timed search of the unbounded board, a power of two
+    const std::uint64_t sparseClockInterval = 64;
+}
+
+std::shared_ptr<TranspositionTable> Engine::defaultTable;
+int Engine::defaultArtificialDelay = 500;
+
+Engine::Engine() : artificialDelay(defaultArtificialDelay), table(defaultTable) {}
+
+Engine::Engine(int artificialDelay, bool logging) : artificialDelay(artificialDelay), logging(logging), table(defaultTable) {}
+
+void Engine::setTranspositionTable(std::shared_ptr<TranspositionTable> table) {
+    this->table = std::move(table);
+}
+
+void Engine::setDefaultTranspositionTable(std::shared_ptr<TranspositionTable> table) {
+    defaultTable = std::move(table);
+}
+
+void Engine::setDefaultArtificialDelay(int milliseconds) {
+    defaultArtificialDelay = milliseconds;
+}
+
+std::uint64_t Engine::positionKey(const Board& board, bool isMax) {
+    // the side to move is part of the key because the computer may be either side and may move first
+    const std::uint64_t xToMoveKey = 0x9E3779B97F4A7C15ULL;
+    return board.hash() ^ (isMax ? xToMoveKey : 0);
+}
+
+void Engine::setSearchLimits(int maxDepth, int moveTime, std::uint64_t nodeBudget) {
+    this->maxDepth = maxDepth;
+    this->moveTime = moveTime;
+    this->nodeBudget = nodeBudget;
+}
+
+ProofResult Engine::prove(const Board& board, char symbol, std::size_t maxNodes, std::size_t tableEntries) {
+    ProofNumberSearch solver(tableEntries);
+    return solver.solve(board, symbol, maxNodes);
+}
+
+int Engine::minimax(Board& board, bool isMax, int depth) {
+    // checked before counting, so a search never visits more positions than its budget
+    if (nodeLimit > 0 && nodes >= nodeLimit) timedOut = true;
+    if (timedOut) return 0;
+    nodes++;
+    int score = evaluator ? evaluator->evaluate() : board.evaluate();
+    int winScore = evaluator ? heuristicWinScore : 10;
 
     // we subract the depth because we want to prioritise the moves that are closest to the top of the tree
-    if (score == 10) return score - depth;
-    if (score == -10) return score + depth;
+    if (score == 10) return winScore - depth;
+    if (score == -10) return -winScore + depth;
+
+    if (evaluator ? evaluator->getEmptyCount() == 0 : !board.isMovesLeft()) return 0;
+
+    // past the horizon we cannot tell how the game ends, so the open lines decide
+    if (depthLimit > 0 && depth >= depthLimit) return evaluator->getScore();
+    if (moveTime > 0 && (nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) timedOut = true;
+    if (timedOut) return 0;
 
-    if (!board.isMovesLeft()) return 0;
+    // a depth-limited result is stored with the plies searched below it and answers any search that needs
+    // no more, solved scores are on a different scale so they have keys of their own. A search with a node
+    // budget leaves the table alone, a hit would save it nodes and make its result depend on what was cached
+    bool useTable = table && nodeLimit == 0;
+    std::uint64_t key = 0;
+    int remainingDepth = evaluator ? depthLimit - depth : solvedDepth;
+    int winFloor = evaluator ? LineEvaluator::maxScore : 0;
+    if (useTable) {
+        key = positionKey(board, isMax) ^ (evaluator ? heuristicKey : 0);
+        TranspositionTable::Entry entry;
+        if (table->probe(key, entry) && entry.depth >= remainingDepth) {
+            return fromStoredScore(entry.score, depth, winFloor);
+        }
+    }
 
     int bestScore = isMax ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min();
+    int bestSquare = -1;
 
-    for (int row = 0; row < 3; row++) {
-        for (int col = 0; col < 3; col++) {
+    for (int row = 0; row < board.getSize(); row++) {
+        for (int col = 0; col < board.getSize(); col++) {
             if (board.getCell(row, col) == ' ') {
                 
-                board.setCell(row, col, isMax ? 'X' : 'O');
+                char symbol = isMax ? 'X' : 'O';
+                board.setCell(row, col, symbol);
+                if (evaluator) evaluator->play(row, col, symbol);
                 int val = minimax(board, !isMax, depth + 1);
+                if (evaluator) evaluator->undo(row, col, symbol);
                 board.setCell(row, col, ' ');
                 
                 if (val <= bestScore && isMax) {
                     bestScore = val;
+                    bestSquare = row * board.getSize() + col;
                 }
                 else if (val >= bestScore && !isMax) {
                     bestScore = val;
+                    bestSquare = row * board.getSize() + col;
                 }
             }
         }
     }
 
+    // a search cut off by the clock or the budget has not seen every move. There is no alpha-beta window,
+    // so every search that finished is exact to its depth
+    if (useTable && !timedOut) {
+        table->store(key, { toStoredScore(bestScore, depth, winFloor), TranspositionTable::exact, remainingDepth, bestSquare });
+    }
+
+    return bestScore;
+}
+
+std::pair<int, int> Engine::findBestMove(const Board& board) {
+    return findBestMove(board, 'O');
+}
+
+std::pair<int, int> Engine::findBestMove(const Board& board, char symbol) {
+    return search(board, symbol).move;
+}
+
+SearchResult Engine::findBestMove(const Board& board, char symbol, std::uint64_t nodeBudget) {
+    std::uint64_t savedBudget = this->nodeBudget;
+    this->nodeBudget = nodeBudget;
+    SearchResult result = search(board, symbol);
+    this->nodeBudget = savedBudget;
+    return result;
+}
+
+SearchResult Engine::search(const Board& position, char symbol) {
+    allocations::ScopeGuard searchScope(allocations::search);
+    tracer::Span span("Engine::search", "engine");
+    sleepArtificialDelay();
+
+    // the search plays its moves on one copy, the callers' boards are only read
+    Board board = position;
+
+    timedOut = false;
+    std::uint64_t startNodes = nodes;
+    nodeLimit = nodeBudget > 0 ? startNodes + nodeBudget : 0;
+    if (moveTime <= 0 && nodeBudget == 0) {
+        SearchResult result = searchToDepth(board, symbol, maxDepth);
+        result.nodes = nodes - startNodes;
+        return result;
+    }
+
+    // iterative deepening, a search cut off by the clock or the budget is thrown away unless it is the first one
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(moveTime);
+    int emptySquares = 0;
+    for (int row = 0; row < board.getSize(); row++) {
+        for (int col = 0; col < board.getSize(); col++) {
+            emptySquares += board.getCell(row, col) == ' ';
+        }
+    }
+    int lastDepth = maxDepth > 0 && maxDepth < emptySquares ? maxDepth : emptySquares;
+    SearchResult result = searchToDepth(board, symbol, 1);
+    for (int depth = 2; depth <= lastDepth && !timedOut; depth++) {
+        SearchResult deeper = searchToDepth(board, symbol, depth == emptySquares ? 0 : depth);
+        if (!timedOut) {
+            result = deeper;
+        }
+    }
+    nodeLimit = 0;
+    result.nodes = nodes - startNodes;
+    return result;
+}
+
+void Engine::sleepArtificialDelay() const {
+    if (artificialDelay > 0) {
+        tracer::Span delaySpan("artificial delay", "engine", "ms", artificialDelay);
+        std::chrono::milliseconds time(artificialDelay);
+        std::this_thread::sleep_for(time);
+    }
+}
+
+SearchResult Engine::search(const SparseBoard& position, char symbol) {
+    allocations::ScopeGuard searchScope(allocations::search);
+    tracer::Span span("Engine::search", "engine");
+    sleepArtificialDelay();
+
+    sparseBoard = position;
+    SparseBoard& board = sparseBoard;
+
+    timedOut = false;
+    std::uint64_t startNodes = nodes;
+    nodeLimit = nodeBudget > 0 ? startNodes + nodeBudget : 0;
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(moveTime);
+    bool deepening = moveTime > 0 || nodeBudget > 0;
+    int lastDepth = maxDepth > 0 ? std::min(maxDepth, maxSparseDepth) : deepening ? maxSparseDepth : sparseDepth;
+    // sized up front, a deeper ply growing the list would move the move lists of the plies above it
+    if (sparseMoves.size() < static_cast<std::size_t>(lastDepth) + 1) {
+        sparseMoves.resize(lastDepth + 1);
+    }
+
+    SearchResult result = searchSparseToDepth(board, symbol, deepening ? 1 : lastDepth);
+    for (int depth = 2; deepening && depth <= lastDepth && !timedOut; depth++) {
+        // a forced win or loss found at this depth will not change deeper down
+        if (std::abs(result.score) > heuristicWinScore - maxSparseDepth) {
+            break;
+        }
+        SearchResult deeper = searchSparseToDepth(board, symbol, depth);
+        if (!timedOut) {
+            result = deeper;
+        }
+    }
+    nodeLimit = 0;
+    result.nodes = nodes - startNodes;
+    tracer::counter("nodes searched", static_cast<long long>(nodes));
+    return result;
+}
+
+SearchResult Engine::searchSparseToDepth(SparseBoard& board, char symbol, int depth) {
+    char other = (symbol == 'X') ? 'O' : 'X';
+    std::vector<RatedMove>& moves = rateSparseMoves(board, symbol, 0);
+    std::pair<int, int> bestMove = moves.front().move;
+    int alpha = -std::numeric_limits<int>::max();
+
+    for (const RatedMove& candidate : moves) {
+        board.play(candidate.move.first, candidate.move.second, symbol);
+        int score = -sparseNegamax(board, other, depth - 1, 1, -std::numeric_limits<int>::max(), -alpha);
+        board.undo(candidate.move.first, candidate.move.second);
+        if (timedOut) {
+            break;
+        }
+        if (score > alpha) {
+            alpha = score;
+            bestMove = candidate.move;
+        }
+    }
+
+    // the score is for the side to move, results are positive when they are good for O
+    return { bestMove, symbol == 'O' ? alpha : -alpha };
+}
+
+int Engine::sparseNegamax(SparseBoard& board, char toMove, int depth, int ply, int alpha, int beta) {
+    if (nodeLimit > 0 && nodes >= nodeLimit) timedOut = true;
+    if (timedOut) return 0;
+    nodes++;
+    // checked before the leaf returns, most nodes are leaves, and often, a node here costs tens of microseconds
+    if (moveTime > 0 && (nodes & (sparseClockInterval - 1)) == 0 && std::chrono::steady_clock::now() >= deadline) timedOut = true;
+    if (timedOut) return 0;
+
+    // only the side that just moved can have won
+    if (board.evaluate() != 0) return -(heuristicWinScore - ply);
+    if (depth <= 0) return toMove == 'O' ? board.getScore() : -board.getScore();
+
+    char other = (toMove == 'X') ? 'O' : 'X';
+    std::vector<RatedMove>& moves = rateSparseMoves(board, toMove, ply);
+    int bestScore = -std::numeric_limits<int>::max();
+    int searched = 0;
+    for (const RatedMove& candidate : moves) {
+        if (searched++ == sparseBranching) {
+            break;
+        }
+        board.play(candidate.move.first, candidate.move.second, toMove);
+        int score = -sparseNegamax(board, other, depth - 1, ply + 1, -beta, -alpha);
+        board.undo(candidate.move.first, candidate.move.second);
+        if (timedOut) {
+            return 0;
+        }
+        bestScore = std::max(bestScore, score);
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            break;
+        }
+    }
     return bestScore;
 }
 
-std::pair<int, int> Engine::findBestMove(Board board) {
-	std::chrono::milliseconds time(artificialDelay);
-	std::this_thread::sleep_for(time);
+std::vector<Engine::RatedMove>& Engine::rateSparseMoves(SparseBoard& board, char toMove, int ply) {
+    std::vector<RatedMove>& moves = sparseMoves[ply];
+    board.generateMoves(sparseCandidates);
+    moves.clear();
+    for (const std::pair<int, int>& move : sparseCandidates) {
+        moves.push_back({ board.rateMove(move.first, move.second, toMove), move });
+    }
+    std::sort(moves.begin(), moves.end(), [](const RatedMove& a, const RatedMove& b) { return a.rating > b.rating; });
+    return moves;
+}
 
+int Engine::scoreMove(const Board& position, std::pair<int, int> move, char symbol) {
+    timedOut = false;
+    nodeLimit = 0;
+    depthLimit = 0;
+    Board board = position;
+    board.setCell(move.first, move.second, symbol);
+    return minimax(board, symbol == 'O', 0);
+}
+
+SearchResult Engine::searchToDepth(Board& board, char symbol, int depthLimit) {
+    this->depthLimit = depthLimit;
+    std::unique_ptr<LineEvaluator> lineEvaluator;
+    if (depthLimit > 0) {
+        lineEvaluator = std::make_unique<LineEvaluator>(board);
+    }
+    evaluator = lineEvaluator.get();
     std::pair<int, int> bestMove = { -1, -1 };
-    
-    int bestScore = std::numeric_limits<int>::min();
+
+    // O maximises the score and X minimises it, so after our move the other side is to play
+    bool isO = symbol == 'O';
+    int bestScore = isO ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
     int score{};
+    std::pair<int, int> firstMove = { -1, -1 };
     
-    for (int row = 0; row < 3; row++) {
-        for (int col = 0; col < 3; col++) {
+    for (int row = 0; row < board.getSize() && !timedOut; row++) {
+        for (int col = 0; col < board.getSize() && !timedOut; col++) {
             if (board.getCell(row, col) == ' ') {
+                if (firstMove.first < 0) {
+                    firstMove = { row, col };
+                }
                 
-                board.setCell(row, col, 'O');
-                score = minimax(board, true, 0);
+                tracer::Span rootMoveSpan("root move", "engine", "square", row * board.getSize() + col + 1);
+                board.setCell(row, col, symbol);
+                if (evaluator) evaluator->play(row, col, symbol);
+                score = minimax(board, isO, 0);
+                if (evaluator) evaluator->undo(row, col, symbol);
+
+                // a move cut off by the clock or the budget scores 0 whatever it is worth, so it cannot compete
+                if (timedOut) {
+                    board.setCell(row, col, ' ');
+                    break;
+                }
                 
-                utils::log("log.txt", board.toString(false), true);
-                utils::log("log.txt", "score: " + std::to_string(score) + "\n", true);
+                if (logging) {
+                    utils::log("log.txt", board.toString(false), true);
+                    utils::log("log.txt", "score: " + std::to_string(score) + "\n", true);
+                }
                 
                 board.setCell(row, col, ' ');
 
-                if (score >= bestScore) {
+                if ((isO && score >= bestScore) || (!isO && score <= bestScore)) {
                     bestScore = score;
                     bestMove = { row, col };
                 }
             }
         }
     }
+    // the limit ran out inside the first move, which is still better than none
+    if (bestMove.first < 0 && firstMove.first >= 0) {
+        bestMove = firstMove;
+        bestScore = 0;
+    }
 	
-    utils::log("log.txt", "best score: " + std::to_string(bestScore) + "\n", true);
-	utils::log("log.txt", "best move: " + std::to_string(bestMove.first) + ", " + std::to_string(bestMove.second) + "\n", true);
-	utils::log("log.txt", "-----------------------------\n", true);
+    if (logging) {
+        utils::log("log.txt", "best score: " + std::to_string(bestScore) + "\n", true);
+        utils::log("log.txt", "best move: " + std::to_string(bestMove.first) + ", " + std::to_string(bestMove.second) + "\n", true);
+        utils::log("log.txt", "-----------------------------\n", true);
+    }
     
-    return bestMove;
+    evaluator = nullptr;
+    tracer::counter("nodes searched", static_cast<long long>(nodes));
+    return { bestMove, bestScore };
 }
\ No newline at end of file
@@ -1,13 +1,97 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <utility>
+#include <vector>
 #include "board.hpp"
+#include "evaluator.hpp"
+#include "proof_search.hpp"
+#include "transposition.hpp"
+#include "unbounded.hpp"
+
+struct SearchResult {
+	std::pair<int, int> move;
+	int score;
+	// positions visited by this search
+	std::uint64_t nodes = 0;
+};
 
 class Engine {
 public:
 	Engine();
-	std::pair<int, int> findBestMove(Board board);
+	/**
+	* @param artificialDelay, milliseconds to sleep before each move so the computer feels like it is thinking
+	* @param logging, whether to write every root move and its score to log.txt
+	*/
+	Engine(int artificialDelay, bool logging);
+	std::pair<int, int> findBestMove(const Board& board);
+	/**
+	* @brief finds the best move for the given side
+	* @param board, the position to search
+	* @param symbol, 'O' to maximise the score or 'X' to minimise it
+	* @return row and column of the best move, or { -1, -1 } if the board is full
+	*/
+	std::pair<int, int> findBestMove(const Board& board, char symbol);
+	/**
+	* @brief findBestMove() with a node budget for this move only, in place of the one set by setSearchLimits()
+	* @param nodeBudget, the most positions the search may visit. The transposition table is neither probed nor
+	* filled while a budget is set, so the result depends only on the position and the budget
+	*/
+	SearchResult findBestMove(const Board& board, char symbol, std::uint64_t nodeBudget);
+	/**
+	* @brief same as findBestMove() but also returns the score of the best move
+	* @return the best move, or { -1, -1 } if the board is full, and its minimax score (positive is good for O)
+	*/
+	SearchResult search(const Board& board, char symbol);
+	/**
+	* @brief search() on the unbounded board, an alpha-beta search over the empty cells near the stones
+	* Moves are tried best rated first and only the best few are searched below the root. The game has no end to
+	* search to, so leaves past the depth limit are scored by the board, and with no limits set it stops at
+	* sparseDepth plies. Wins score like a depth-limited search's.
+	*/
+	SearchResult search(const SparseBoard& board, char symbol);
+	/**
+	* @brief the score search() would give one move, searched to the end of the game whatever the limits
+	* @param move, row and column of an empty square
+	*/
+	int scoreMove(const Board& board, std::pair<int, int> move, char symbol);
+	/**
+	* @brief solver mode, proves the position won, lost or drawn for symbol with df-pn instead of scoring it
+	* Works on any board size, where an exhaustive minimax could not finish.
+	* @param maxNodes, the outcome is unknown if the proof needs more nodes than this
+	* @param tableEntries, size of the proof table, which bounds the memory used
+	*/
+	ProofResult prove(const Board& board, char symbol, std::size_t maxNodes = 50000000, std::size_t tableEntries = 1 << 22);
+	/**
+	* @brief caches minimax scores in the given table, which may be shared with other engines and processes
+	*/
+	void setTranspositionTable(std::shared_ptr<TranspositionTable> table);
+	/**
+	* @brief the table every Engine constructed from now on starts with, nullptr for none
+	*/
+	static void setDefaultTranspositionTable(std::shared_ptr<TranspositionTable> table);
+	static std::shared_ptr<TranspositionTable> getDefaultTranspositionTable() { return defaultTable; }
+	/**
+	* @brief the artificial delay of every Engine constructed from now on without one, 500 ms to start with
+	*/
+	static void setDefaultArtificialDelay(int milliseconds);
+	/**
+	* @brief limits the search, positions past the depth limit are scored by a LineEvaluator
+	* Wins then score 2 * LineEvaluator::maxScore less the depth, so they still outweigh any heuristic score.
+	* @param maxDepth, plies to search below each root move, 0 for no limit
+	* @param moveTime, milliseconds per move, 0 for no limit. The search deepens one ply at a time
+	* and plays the best move of the deepest search that finished in time.
+	* @param nodeBudget, positions to visit per move, 0 for no limit. Deepens like a timed search, but
+	* stops after exactly nodeBudget positions however busy the machine is, and does not use the transposition table.
+	*/
+	void setSearchLimits(int maxDepth, int moveTime, std::uint64_t nodeBudget = 0);
+	/**
+	* @return positions visited by minimax since the engine was created
+	*/
+	std::uint64_t getNodeCount() const { return nodes; }
 	
 private:
 	/**
@@ -17,8 +101,46 @@ private:
 	* @param depth, an integer representing the recursive level of the function call
 	* @return an integer representing the score the the given position, 0 means the position results in a draw
 	*/
-	int minimax(Board board, bool isMax, int depth);
+	int minimax(Board& board, bool isMax, int depth);
+	SearchResult searchToDepth(Board& board, char symbol, int depthLimit);
+	struct RatedMove {
+		int rating;
+		std::pair<int, int> move;
+	};
+	/**
+	* @return score for toMove, alpha-beta over the next depth plies
+	*/
+	int sparseNegamax(SparseBoard& board, char toMove, int depth, int ply, int alpha, int beta);
+	SearchResult searchSparseToDepth(SparseBoard& board, char symbol, int depth);
+	/**
+	* @brief fills the move list of ply with the candidate moves of toMove, best rated first
+	*/
+	std::vector<RatedMove>& rateSparseMoves(SparseBoard& board, char toMove, int ply);
+	void sleepArtificialDelay() const;
+	static std::uint64_t positionKey(const Board& board, bool isMax);
 	int artificialDelay = 500;
+	bool logging = true;
+	std::shared_ptr<TranspositionTable> table;
+	static std::shared_ptr<TranspositionTable> defaultTable;
+	static int defaultArtificialDelay;
+	int maxDepth = 0;
+	int moveTime = 0;
+	std::uint64_t nodeBudget = 0;
+	// the depth limit of the search in progress, and when it has to stop if the move is timed
+	int depthLimit = 0;
+	// set while a depth-limited search is running, follows every move the search makes
+	LineEvaluator* evaluator = nullptr;
+	std::chrono::steady_clock::time_point deadline;
+	// node count at which the search in progress stops, 0 if it has no budget
+	std::uint64_t nodeLimit = 0;
+	// set when the clock or the node budget stops the search
+	bool timedOut = false;
+	std::uint64_t nodes = 0;
+	// move lists of every ply of a sparse search, kept from one search to the next
+	std::vector<std::vector<RatedMove>> sparseMoves;
+	std::vector<std::pair<int, int>> sparseCandidates;
+	// the board a sparse search plays its moves on, copied into so its maps keep their capacity between searches
+	SparseBoard sparseBoard;
 
 };
 
@@ -0,0 +1,20 @@
+#ifndef EVALUATION_WEIGHTS_HPP
+#define EVALUATION_WEIGHTS_HPP
+
+// written by tic-tac-toe --tune, run it again rather than editing the numbers by hand
+
+/**
+* @brief weights of the LineEvaluator terms, fitted to the results of self-play games
+*/
+namespace evaluationWeights {
+	// weight of each window through a stone, which favours the centre
+	constexpr int centre = 1;
+	// weight of a window holding stones of only one side, by the number of stones it still needs, index 0 unused
+	constexpr int openWindows[15] = { 0, 1869, 227, 76, 12, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+	// the same for a window with the other side's stone or the edge of the board just past one of its ends
+	constexpr int blockedWindows[15] = { 0, 769, 224, 70, 20, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+	// the position set and fit these weights came from
+	constexpr const char* source = "164094 positions from 9x9 with 5 in a row";
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include "evaluation_weights.hpp"
+#include "evaluator.hpp"
+
+namespace {
+	const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+}
+
+LineEvaluator::LineEvaluator(const Board& board)
+	: size(board.getSize()), winLength(board.getWinLength()), emptyCount(board.getSize() * board.getSize()) {
+	// a complete window is a win, which evaluate() reports, so it adds nothing to the score
+	weights.resize(winLength + 1);
+	blockedWeights.resize(winLength + 1);
+	for (int stones = 1; stones < winLength; stones++) {
+		weights[stones] = evaluationWeights::openWindows[winLength - stones];
+		blockedWeights[stones] = evaluationWeights::blockedWindows[winLength - stones];
+	}
+
+	std::vector<std::vector<int>> cellWindows(size * size);
+	std::vector<std::vector<int>> cellFlanks(size * size);
+	for (int row = 0; row < size; row++) {
+		for (int col = 0; col < size; col++) {
+			for (const auto& direction : directions) {
+				int lastRow = row + direction[0] * (winLength - 1);
+				int lastCol = col + direction[1] * (winLength - 1);
+				if (lastRow >= size || lastCol < 0 || lastCol >= size) {
+					continue;
+				}
+				for (int i = 0; i < winLength; i++) {
+					cellWindows[(row + direction[0] * i) * size + col + direction[1] * i].push_back(static_cast<int>(windows.size()));
+				}
+				Window window{};
+				for (int end = -1; end <= winLength; end += winLength + 1) {
+					int flankRow = row + direction[0] * end;
+					int flankCol = col + direction[1] * end;
+					if (flankRow < 0 || flankRow >= size || flankCol < 0 || flankCol >= size) {
+						window.edgeFlanks++;
+					}
+					else {
+						cellFlanks[flankRow * size + flankCol].push_back(static_cast<int>(windows.size()));
+					}
+				}
+				windows.push_back(window);
+			}
+		}
+	}
+
+	windowStarts.push_back(0);
+	for (const auto& indices : cellWindows) {
+		windowIndices.insert(windowIndices.end(), indices.begin(), indices.end());
+		windowStarts.push_back(static_cast<int>(windowIndices.size()));
+	}
+	flankStarts.push_back(0);
+	for (const auto& indices : cellFlanks) {
+		flankIndices.insert(flankIndices.end(), indices.begin(), indices.end());
+		flankStarts.push_back(static_cast<int>(flankIndices.size()));
+	}
+
+	for (int row = 0; row < size; row++) {
+		for (int col = 0; col < size; col++) {
+			char cell = board.getCell(row, col);
+			if (cell == 'X' || cell == 'O') {
+				play(row, col, cell);
+			}
+		}
+	}
+}
+
+void LineEvaluator::play(int row, int col, char symbol) {
+	update(row, col, symbol, 1);
+	emptyCount--;
+}
+
+void LineEvaluator::undo(int row, int col, char symbol) {
+	update(row, col, symbol, -1);
+	emptyCount++;
+}
+
+int LineEvaluator::getScore() const {
+	return static_cast<int>(std::clamp<long long>(score, -(maxScore - 1), maxScore - 1));
+}
+
+void LineEvaluator::update(int row, int col, char symbol, int change) {
+	int cell = row * size + col;
+	for (int i = windowStarts[cell]; i < windowStarts[cell + 1]; i++) {
+		Window& window = windows[windowIndices[i]];
+		score -= windowValue(window);
+		std::uint8_t& count = symbol == 'X' ? window.xCount : window.oCount;
+		if (count == winLength) {
+			(symbol == 'X' ? xWins : oWins)--;
+		}
+		count = static_cast<std::uint8_t>(count + change);
+		if (count == winLength) {
+			(symbol == 'X' ? xWins : oWins)++;
+		}
+		score += windowValue(window);
+	}
+	for (int i = flankStarts[cell]; i < flankStarts[cell + 1]; i++) {
+		Window& window = windows[flankIndices[i]];
+		score -= windowValue(window);
+		std::uint8_t& flanks = symbol == 'X' ? window.xFlanks : window.oFlanks;
+		flanks = static_cast<std::uint8_t>(flanks + change);
+		score += windowValue(window);
+	}
+	int centre = evaluationWeights::centre * (windowStarts[cell + 1] - windowStarts[cell]);
+	score += symbol == 'O' ? change * centre : -change * centre;
+}
+
+void LineEvaluator::getFeatures(int* features) const {
+	std::fill(features, features + featureCount, 0);
+	for (const Window& window : windows) {
+		// every stone in the window counts it once as a window through that stone, open or not
+		features[0] += window.oCount - window.xCount;
+		if (window.xCount > 0 && window.oCount > 0) {
+			continue;
+		}
+		if (window.oCount > 0 && window.oCount < winLength) {
+			bool blocked = window.edgeFlanks + window.xFlanks > 0;
+			features[(blocked ? blockedFeatures : 0) + winLength - window.oCount]++;
+		}
+		if (window.xCount > 0 && window.xCount < winLength) {
+			bool blocked = window.edgeFlanks + window.oFlanks > 0;
+			features[(blocked ? blockedFeatures : 0) + winLength - window.xCount]--;
+		}
+	}
+}
+
+int LineEvaluator::windowValue(const Window& window) const {
+	if (window.xCount > 0 && window.oCount > 0) {
+		return 0;
+	}
+	if (window.oCount > 0) {
+		return window.edgeFlanks + window.xFlanks > 0 ? blockedWeights[window.oCount] : weights[window.oCount];
+	}
+	if (window.xCount > 0) {
+		return window.edgeFlanks + window.oFlanks > 0 ? -blockedWeights[window.xCount] : -weights[window.xCount];
+	}
+	return 0;
+}
@@ -0,0 +1,77 @@
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include <cstdint>
+#include <vector>
+#include "board.hpp"
+
+/**
+* @brief heuristic score of a position from the lines that can still be won, kept up to date move by move
+* Every run of winLength cells in a row, column or diagonal is a window. A window holding stones of only one
+* side is worth more the more stones it holds, a window holding both is dead. A live window is blocked when a
+* cell just past either end of it is off the board or holds a stone of the other side, so the line cannot grow
+* that way, and open otherwise. Playing or taking back a stone only touches the windows through its cell and the
+* windows it flanks, so the score, the winner and the empty cell count are always a member read away instead of
+* a scan of the whole board.
+* The weights of open and blocked windows by the stones they still need, and of the windows through every stone
+* as a measure of centre control, come from evaluation_weights.hpp, which WeightTuner fits to self-play.
+*/
+class LineEvaluator {
+	public:
+		/**
+		* @brief counts the windows of the stones already on the board
+		*/
+		explicit LineEvaluator(const Board& board);
+		void play(int row, int col, char symbol);
+		/**
+		* @brief takes back a stone placed by play()
+		*/
+		void undo(int row, int col, char symbol);
+		/**
+		* @return the same as Board::evaluate(), 10 if O has won, -10 if X has won, 0 otherwise
+		*/
+		int evaluate() const { return oWins > 0 ? 10 : xWins > 0 ? -10 : 0; }
+		/**
+		* @return sum of the open windows, positive is good for O, always less than maxScore in size
+		*/
+		int getScore() const;
+		int getEmptyCount() const { return emptyCount; }
+		/**
+		* @brief the terms getScore() weighs, each counted for O less X
+		* @param features, featureCount values: the windows through every stone, then the open windows
+		* needing 1 up to BitBoard::maxSize - 1 more stones, then the blocked windows needing as many
+		*/
+		void getFeatures(int* features) const;
+		static const int maxScore = 1 << 28;
+		static const int featureCount = 2 * BitBoard::maxSize - 1;
+		// features[blockedFeatures + missing] counts the blocked windows that still need missing stones
+		static const int blockedFeatures = BitBoard::maxSize - 1;
+	private:
+		struct Window {
+			std::uint8_t xCount;
+			std::uint8_t oCount;
+			// how many of the two cells just past the ends hold X, hold O or lie off the board
+			std::uint8_t xFlanks;
+			std::uint8_t oFlanks;
+			std::uint8_t edgeFlanks;
+		};
+		void update(int row, int col, char symbol, int change);
+		int windowValue(const Window& window) const;
+		int size;
+		int winLength;
+		int emptyCount;
+		int xWins = 0;
+		int oWins = 0;
+		long long score = 0;
+		std::vector<Window> windows;
+		// windows through each cell, cell i owns windowIndices[windowStarts[i]] up to windowIndices[windowStarts[i + 1]]
+		std::vector<int> windowStarts;
+		std::vector<int> windowIndices;
+		// windows each cell lies just past the end of, laid out the same way
+		std::vector<int> flankStarts;
+		std::vector<int> flankIndices;
+		std::vector<int> weights;
+		std::vector<int> blockedWeights;
+};
+
+#endif
@@ -1,19 +1,93 @@
 #include <iostream>
+#include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include "game.hpp"
+#include "allocations.hpp"
 #include "board.hpp"
 #include "utils.hpp"
 #include "engine.hpp"
+#include "keyboard.hpp"
 #include "player.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "tracer.hpp"
 
-Game::Game(Renderer& renderer) : isBotGame(false), botStarts(false), renderer(renderer) {
+namespace {
+    bool isBlank(int key) {
+        return key == ' ' || key == '\n' || key == '\r' || key == '\t';
+    }
+
+    // allocations the game loop itself has made, engine searches and logging count against their own scopes
+    std::uint64_t loopAllocations() {
+        return allocations::getCounts(allocations::turn).allocations + allocations::getCounts(allocations::render).allocations;
+    }
+
+    /**
+    * @brief runs job on a thread started once, one run at a time, so handing it a run allocates nothing
+    */
+    template <typename Job>
+    class Worker {
+        public:
+            explicit Worker(Job job) : job(std::move(job)), thread([this] { loop(); }) {}
+            ~Worker() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                thread.join();
+            }
+            void start() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    running = true;
+                }
+                wake.notify_one();
+            }
+            bool isDone() {
+                std::lock_guard<std::mutex> lock(mutex);
+                return !running;
+            }
+            void wait() {
+                std::unique_lock<std::mutex> lock(mutex);
+                finished.wait(lock, [this] { return !running; });
+            }
+        private:
+            void loop() {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    wake.wait(lock, [this] { return running || stopping; });
+                    if (stopping) {
+                        return;
+                    }
+                    lock.unlock();
+                    job();
+                    lock.lock();
+                    running = false;
+                    finished.notify_one();
+                }
+            }
+            Job job;
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable finished;
+            bool running = false;
+            bool stopping = false;
+            std::thread thread;
+    };
+}
+
+Game::Game(Renderer& renderer) : isOver(false), isBotGame(false), botStarts(false), renderer(renderer), state(awaitingInput) {
     player1 = std::make_unique<HumanPlayer>('X');
     player2 = std::make_unique<HumanPlayer>('O');
     currentPlayer = player1.get();
+    formatPrompts();
 }
 
-Game::Game(bool botStarts, Renderer& renderer) : isBotGame(true), botStarts(botStarts), renderer(renderer) {
+Game::Game(bool botStarts, Renderer& renderer) : isOver(false), isBotGame(true), botStarts(botStarts), renderer(renderer), state(awaitingInput) {
     if (botStarts) {
         player1 = std::make_unique<ComputerPlayer>('O');
         player2 = std::make_unique<HumanPlayer>('X');
@@ -23,6 +97,7 @@ Game::Game(bool botStarts, Renderer& renderer) : isBotGame(true), botStarts(botS
         player2 = std::make_unique<ComputerPlayer>('O');
     }
     currentPlayer = player1.get();
+    formatPrompts();
 }
 
 void Game::displayStartingScreen() {
@@ -59,69 +134,165 @@ void Game::displayStartingScreen() {
 
 void Game::start(Renderer &renderer) {
 
-    isOver = false;
+    Keyboard keyboard;
+    int pendingKey = Keyboard::noKey;
+    StepResult result = reset();
+    // the engine moves on its own thread so the first key typed meanwhile is read at once and played next
+    int computerSquare = -1;
+    Worker computerMove([this, &computerSquare] {
+        allocations::ScopeGuard turnScope(allocations::turn);
+        computerSquare = findComputerMove();
+    });
+    [[maybe_unused]] bool firstTurn = true;
+
+    while (result.state != gameOver) {
+        [[maybe_unused]] std::uint64_t allocationsBefore = loopAllocations();
+        allocations::ScopeGuard turnScope(allocations::turn);
+        tracer::Span turnSpan("turn", "game");
+        profiler::dumpIfRequested("latency.txt");
 
-    Board board;
+        if (result.effects & renderPlayingScreen) {
+            profiler::ScopedTimer timer(profiler::render);
+            allocations::ScopeGuard renderScope(allocations::render);
+            renderer.clearScreen();
+            renderer.renderPlayingScreen(board, errorMessage, promptMessage);
+        }
 
-    std::string errorMessage{ "" };
+        if (result.state == awaitingInput) {
+            int key = pendingKey;
+            pendingKey = Keyboard::noKey;
+            // a key typed ahead during the computer's move was read without waiting, so no replayed turn starts with it
+            bool waited = false;
+            {
+                profiler::ScopedTimer timer(profiler::inputWait);
+                tracer::Span span("Keyboard::readKey", "player");
+                while (key == Keyboard::noKey || isBlank(key)) {
+                    key = keyboard.readKey();
+                    waited = true;
+                    if (isBlank(key)) {
+                        replay::rejectKey();
+                    }
+                }
+            }
+            if (key == Keyboard::endOfInput || key == 'q' || key == 'Q') {
+                return;
+            }
+            // one character always fits in the string's own storage
+            result = step(std::string(1, static_cast<char>(key)));
+            if (waited && !errorMessage.empty()) {
+                replay::rejectKey();
+            }
+        }
+        else if (result.effects & runComputerMove) {
+            computerMove.start();
+            while (pendingKey == Keyboard::noKey && !computerMove.isDone()) {
+                int key = keyboard.readKey(1);
+                pendingKey = isBlank(key) ? Keyboard::noKey : key;
+            }
+            computerMove.wait();
+            result = playComputerMove(computerSquare);
+        }
+        // the tracer's buffers grow while it records, which is not the loop's doing
+        assert(firstTurn || !allocations::enabled || tracer::isEnabled() || loopAllocations() == allocationsBefore);
+        firstTurn = false;
+    }
 
-    do {
-		board.updateStatus = Board::UpdateStatus::notUpdated;
+    {
+        allocations::ScopeGuard renderScope(allocations::render);
+        renderer.clearScreen();
+        renderer.renderGameOverScreen(board, getWinner());
+    }
 
-        int squareNum{};
+	renderer.renderText("Press 'q' to exit...");
+    while (true) {
+        int key = keyboard.readKey();
+        if (key == Keyboard::endOfInput || key == 'q' || key == 'Q') {
+            break;
+        }
+    }
+}
 
-		std::string promptMessage = currentPlayer->getName() + " (" + currentPlayer->getSymbol() + "), enter your move (1-9): ";
+Game::StepResult Game::reset() {
+    board = Board();
+    errorMessage = {};
+    currentPlayer = player1.get();
+    isOver = false;
+    return nextTurn();
+}
 
-		renderer.clearScreen();
-		renderer.renderPlayingScreen(board, errorMessage, promptMessage);
+Game::StepResult Game::step(const std::string& input) {
+    if (state != awaitingInput) {
+        return { state, state == computerTurn ? runComputerMove : noEffect };
+    }
 
-		squareNum = currentPlayer->prompt(board, renderer, promptMessage);
+    int squareNum{};
+    {
+        profiler::ScopedTimer timer(profiler::inputParse);
+        squareNum = HumanPolicy::parseSquareNum(input);
+    }
+    return playMove(squareNum);
+}
+
+int Game::findComputerMove() {
+    profiler::ScopedTimer timer(profiler::engine);
+    return currentPlayer->prompt(board, renderer, promptMessage);
+}
+
+Game::StepResult Game::playComputerMove(int squareNum) {
+    if (state != computerTurn) {
+        return { state, noEffect };
+    }
+    return playMove(squareNum);
+}
+
+Game::StepResult Game::playMove(int squareNum) {
+    board.updateStatus = Board::UpdateStatus::notUpdated;
+
+    {
+        profiler::ScopedTimer timer(profiler::boardUpdate);
         Board::UpdateStatus updateStatus = board.updateBoard(squareNum, currentPlayer->getSymbol());
         if (updateStatus == Board::UpdateStatus::success) {
-            errorMessage = "";
-			currentPlayer = (currentPlayer == player1.get()) ? player2.get() : player1.get();
+            errorMessage = {};
+            currentPlayer = (currentPlayer == player1.get()) ? player2.get() : player1.get();
         }
         else {
-			board.handleError(updateStatus, squareNum, &errorMessage);
+            errorMessage = board.handleError(updateStatus, squareNum, errorBuffer.data(), errorBuffer.size());
         }
 
         int eval = board.evaluate();
-        isOver = (eval != 0)  || !board.isMovesLeft();
-
-    } while (!isOver);
+        isOver = (eval != 0) || !board.isMovesLeft();
+    }
 
-    renderer.clearScreen();
-    //board.printExampleBoard();
-    //board.print();
-    if (board.evaluate() == +10) {
-        //std::cout << "\nGood game! Player 2 wins!" << std::endl;
-		//renderer.renderText("Good game! Player 2 wins!");
-		renderer.renderGameOverScreen(board, 'O');
+    if (isOver) {
+        state = gameOver;
+        return { state, renderGameOverScreen };
     }
-    else if (board.evaluate() == -10) {
-        //std::cout << "\nGood game! Player 1 wins!" << std::endl;
-		//renderer.renderText("Good game! Player 1 wins!");
-        renderer.renderGameOverScreen(board, 'X');
+    return nextTurn();
+}
+
+Game::StepResult Game::nextTurn() {
+    promptMessage = prompts[currentPlayer == player1.get() ? 0 : 1];
+    state = currentPlayer->isComputer() ? computerTurn : awaitingInput;
+    return { state, renderPlayingScreen | (state == computerTurn ? runComputerMove : noEffect) };
+}
+
+void Game::formatPrompts() {
+    const Player* players[] = { player1.get(), player2.get() };
+    for (int i = 0; i < 2; i++) {
+        prompts[i] = players[i]->getName() + " (" + players[i]->getSymbol() + "), enter your move (1-9): ";
     }
-    else if (board.evaluate() == 0) {
-        //std::cout << "\nGood game! It's a TIE!" << std::endl;
-		//renderer.renderText("Good game! It's a TIE!");
-        renderer.renderGameOverScreen(board, 'T');
+}
+
+char Game::getWinner() const {
+    if (state != gameOver) {
+        return ' ';
     }
-    else {
-        //std::cout << "\nGood game!" << std::endl;
-		//renderer.renderText("Good game!");
-		renderer.renderGameOverScreen(board, 'T');
+    int eval = board.evaluate();
+    if (eval == +10) {
+        return 'O';
     }
-
-    // Keep running until 'q' is pressed
-    //std::cout << "Press 'q' and Enter to exit..." << std::endl;
-	renderer.renderText("Press 'q' and Enter to exit...");
-    char input;
-    while (std::cin >> input) {
-        if (input == 'q' || input == 'Q') {
-            break;
-        }
-        std::cout << "Press 'q' and Enter to exit..." << std::endl;
+    if (eval == -10) {
+        return 'X';
     }
+    return 'T';
 }
\ No newline at end of file
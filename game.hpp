@@ -1,16 +1,81 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include <array>
+#include <string>
+#include <string_view>
 #include "player.hpp"
 #include "renderer.hpp"
 
 class Game {
 	public:
+		enum State {
+			awaitingInput,
+			computerTurn,
+			gameOver,
+		};
+		enum Effect {
+			noEffect = 0,
+			renderPlayingScreen = 1 << 0,
+			renderGameOverScreen = 1 << 1,
+			// the computer is to move, the driver runs findComputerMove() and hands its square to playComputerMove()
+			runComputerMove = 1 << 2,
+		};
+		/**
+		* @brief what a single step did: the state the game is now in and what the driver should draw
+		*/
+		struct StepResult {
+			State state;
+			int effects;
+		};
 		Game(Renderer& renderer);
 		Game(bool botStarts, Renderer& renderer);
+		// the messages point into the game's own buffers
+		Game(const Game&) = delete;
+		Game& operator=(const Game&) = delete;
 		void displayStartingScreen();
+		/**
+		* @brief plays a whole game on this thread, reading a move per keystroke and rendering every turn
+		* Keys typed while the computer is thinking are kept for the next move. q or the end of input quits.
+		* After the first turn a turn makes no heap allocations, which a debug build checks when allocations are
+		* tracked. Prompts are formatted once per game, errors go into a fixed buffer, and the computer moves on
+		* a thread started once per game.
+		*/
 		void start(Renderer &renderer);
+		/**
+		* @brief starts a new game with an empty board
+		*/
+		StepResult reset();
+		/**
+		* @brief advances the game by one event without blocking
+		* A computer turn is never played here, the result asks the driver for it with runComputerMove instead.
+		* @param input, the text typed by the human player when the state is awaitingInput, ignored otherwise
+		* @return the new state and the render requests for the driver
+		*/
+		StepResult step(const std::string& input = "");
+		/**
+		* @brief the computer's search for its move, the engine's artificial delay included
+		* Reads the game without changing it, so the driver may run it on another thread as long as nothing steps
+		* this game until it returns.
+		* @return the square to pass to playComputerMove()
+		*/
+		int findComputerMove();
+		/**
+		* @brief plays the square findComputerMove() chose
+		*/
+		StepResult playComputerMove(int squareNum);
+		State getState() const { return state; }
+		const Board& getBoard() const { return board; }
+		std::string_view getErrorMessage() const { return errorMessage; }
+		std::string_view getPromptMessage() const { return promptMessage; }
+		/**
+		* @return 'X' or 'O' for the winner, 'T' for a tie, ' ' while the game is still being played
+		*/
+		char getWinner() const;
 	private:
+		StepResult playMove(int squareNum);
+		StepResult nextTurn();
+		void formatPrompts();
 		bool isOver;
 		bool isBotGame;
 		bool botStarts;
@@ -18,6 +83,14 @@ class Game {
 		std::unique_ptr<Player> player2;
 		Player* currentPlayer;
 		Renderer& renderer;
+		State state;
+		Board board;
+		std::string_view errorMessage;
+		std::string_view promptMessage;
+		// the prompts of player1 and player2, a turn only points promptMessage at one of them
+		std::array<std::string, 2> prompts;
+		// holds errorMessage when it has to name the square
+		std::array<char, 64> errorBuffer{};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,191 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "harness.hpp"
+#include "board.hpp"
+#include "engine.hpp"
+#include "legacy.hpp"
+#include "policies.hpp"
+#include "utils.hpp"
+
+namespace {
+	enum Comparison {
+		// the score must match the legacy score exactly
+		compareScore,
+		// the move must score the same as the legacy move
+		compareMove,
+		// the move must keep the same outcome (win, draw or loss) as the legacy move
+		compareOutcome,
+	};
+
+	struct EngineMode {
+		std::string name;
+		std::function<SearchResult(const Board&)> search;
+		Comparison comparison;
+	};
+
+	int sign(int value) {
+		return (value > 0) - (value < 0);
+	}
+
+	struct ModeReport {
+		int identical = 0;
+		int equivalent = 0;
+		int mismatched = 0;
+		double seconds = 0;
+	};
+
+	void toGrid(const Board& board, char (&grid)[3][3]) {
+		for (int row = 0; row < 3; row++) {
+			for (int col = 0; col < 3; col++) {
+				grid[row][col] = board.getCell(row, col);
+			}
+		}
+	}
+
+	/**
+	* @brief the legacy score of O playing the given move, found the way legacy::findBestMove scores its root moves
+	*/
+	int legacyMoveScore(const Board& board, std::pair<int, int> move) {
+		char grid[3][3];
+		toGrid(board, grid);
+		grid[move.first][move.second] = 'O';
+		return legacy::minimax(grid, true, 1);
+	}
+
+	/**
+	* @brief legacy::findBestMove starts its search one ply deeper than Engine, so every non-zero score is one closer to zero
+	*/
+	int toLegacyScore(int score) {
+		return score > 0 ? score - 1 : score < 0 ? score + 1 : 0;
+	}
+
+	void collectPositions(Board& board, char symbol, std::vector<bool>& seen, std::vector<int>& positions) {
+		int code = board.toCode();
+		if (seen[code * 2 + (symbol == 'O' ? 1 : 0)]) {
+			return;
+		}
+		seen[code * 2 + (symbol == 'O' ? 1 : 0)] = true;
+		if (board.evaluate() != 0 || !board.isMovesLeft()) {
+			return;
+		}
+		if (symbol == 'O') {
+			positions.push_back(code);
+		}
+		for (int row = 0; row < 3; row++) {
+			for (int col = 0; col < 3; col++) {
+				if (board.getCell(row, col) == ' ') {
+					board.setCell(row, col, symbol);
+					collectPositions(board, symbol == 'X' ? 'O' : 'X', seen, positions);
+					board.setCell(row, col, ' ');
+				}
+			}
+		}
+	}
+
+	std::vector<EngineMode> engineModes() {
+		auto engine = std::make_shared<Engine>(0, false);
+		engine->setTranspositionTable(nullptr);
+		auto cachedEngine = std::make_shared<Engine>(0, false);
+		cachedEngine->setTranspositionTable(std::make_shared<TranspositionTable>(1 << 16));
+		auto table = std::make_shared<TableLookupPolicy>();
+		return {
+			{ "engine", [engine](const Board& board) { return engine->search(board, 'O'); }, compareScore },
+			{ "engine+tt", [cachedEngine](const Board& board) { return cachedEngine->search(board, 'O'); }, compareScore },
+			{ "table", [table](const Board& board) {
+				return SearchResult{ utils::getPair(table->chooseMove(board, 'O')), 0 };
+			}, compareMove },
+			{ "proof", [engine](const Board& board) {
+				ProofResult proof = engine->prove(board, 'O', 1000000, 1 << 16);
+				int score = proof.outcome == ProofResult::won ? 10 : proof.outcome == ProofResult::lost ? -10 : 0;
+				return SearchResult{ proof.move, score };
+			}, compareOutcome },
+		};
+	}
+}
+
+int runDifferentialHarness() {
+	legacy::setDebugLogging(false);
+
+	// O moves second when X starts and first when the computer starts, so both openings are explored
+	std::vector<bool> seen(Board::codeCount * 2, false);
+	std::vector<int> positions;
+	Board empty;
+	collectPositions(empty, 'X', seen, positions);
+	collectPositions(empty, 'O', seen, positions);
+
+	std::vector<std::pair<int, int>> legacyMoves(positions.size());
+	auto startTime = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < positions.size(); i++) {
+		char grid[3][3];
+		toGrid(Board::fromCode(positions[i]), grid);
+		legacyMoves[i] = legacy::findBestMove(grid);
+	}
+	double legacySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	std::vector<EngineMode> modes = engineModes();
+	std::vector<ModeReport> reports(modes.size());
+	std::vector<SearchResult> results(positions.size());
+
+	for (size_t m = 0; m < modes.size(); m++) {
+		startTime = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < positions.size(); i++) {
+			results[i] = modes[m].search(Board::fromCode(positions[i]));
+		}
+		reports[m].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		for (size_t i = 0; i < positions.size(); i++) {
+			Board board = Board::fromCode(positions[i]);
+			int legacyScore = legacyMoveScore(board, legacyMoves[i]);
+			bool isLegalMove = results[i].move.first >= 0 && board.getCell(results[i].move.first, results[i].move.second) == ' ';
+			bool scoreMatches = modes[m].comparison != compareScore || toLegacyScore(results[i].score) == legacyScore;
+			if (modes[m].comparison == compareOutcome) {
+				scoreMatches = sign(results[i].score) == sign(legacyScore);
+			}
+
+			if (results[i].move == legacyMoves[i] && scoreMatches) {
+				reports[m].identical++;
+			}
+			else if (isLegalMove && scoreMatches && (modes[m].comparison == compareOutcome
+				? sign(legacyMoveScore(board, results[i].move)) == sign(legacyScore)
+				: legacyMoveScore(board, results[i].move) == legacyScore)) {
+				reports[m].equivalent++;
+			}
+			else {
+				reports[m].mismatched++;
+				if (reports[m].mismatched <= 5) {
+					std::cout << modes[m].name << " disagrees with legacy on\n" << board.toString(false)
+						<< "legacy move " << utils::getSquareNum(legacyMoves[i].first, legacyMoves[i].second)
+						<< " (score " << legacyScore << "), " << modes[m].name << " move "
+						<< utils::getSquareNum(results[i].move.first, results[i].move.second)
+						<< " (score " << toLegacyScore(results[i].score) << ")\n\n";
+				}
+			}
+		}
+	}
+
+	std::cout << positions.size() << " positions with O to move\n\n"
+		<< std::left << std::setw(10) << "mode" << std::right
+		<< std::setw(11) << "identical" << std::setw(12) << "equivalent" << std::setw(12) << "mismatched"
+		<< std::setw(12) << "time (ms)" << std::setw(10) << "speedup" << "\n"
+		<< std::left << std::setw(10) << "legacy" << std::right
+		<< std::setw(11) << "-" << std::setw(12) << "-" << std::setw(12) << "-"
+		<< std::setw(12) << std::fixed << std::setprecision(1) << legacySeconds * 1000 << std::setw(10) << "1.0x" << "\n";
+
+	bool passed = true;
+	for (size_t m = 0; m < modes.size(); m++) {
+		double speedup = reports[m].seconds > 0 ? legacySeconds / reports[m].seconds : 0;
+		std::cout << std::left << std::setw(10) << modes[m].name << std::right
+			<< std::setw(11) << reports[m].identical << std::setw(12) << reports[m].equivalent
+			<< std::setw(12) << reports[m].mismatched
+			<< std::setw(12) << std::fixed << std::setprecision(1) << reports[m].seconds * 1000
+			<< std::setw(9) << std::setprecision(1) << speedup << "x" << "\n";
+		passed = passed && reports[m].mismatched == 0;
+	}
+
+	std::cout << (passed ? "\nAll engine modes agree with the legacy engine." : "\nSome engine modes disagree with the legacy engine!") << std::endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#ifndef HARNESS_HPP
+#define HARNESS_HPP
+
+/**
+* @brief checks every engine mode against the legacy engine in main_old.cpp
+* Every reachable 3x3 position where O is to move is searched by each mode. Moves must match the legacy
+* move, or score the same as it under the legacy engine, and scores must match after allowing for the
+* legacy search starting one ply deeper. Prints a report with each mode's speedup over the legacy engine.
+* @return 0 if every mode agrees with the legacy engine, 1 otherwise
+*/
+int runDifferentialHarness();
+
+#endif
@@ -0,0 +1,149 @@
+#include <iostream>
+#include "keyboard.hpp"
+#include "replay.hpp"
+
+#ifdef _WIN32
+
+#include <chrono>
+#include <thread>
+#include <conio.h>
+
+Keyboard::Keyboard() : raw(!replay::isReplaying()) {}
+
+Keyboard::~Keyboard() {}
+
+int Keyboard::readKey(int timeoutMs) {
+	if (replay::isReplaying()) {
+		return replay::nextKey(timeoutMs);
+	}
+	int key = readTerminal(timeoutMs);
+	if (replay::isRecording()) {
+		replay::recordKey(key);
+	}
+	return key;
+}
+
+int Keyboard::readTerminal(int timeoutMs) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	while (timeoutMs >= 0 && !_kbhit()) {
+		if (std::chrono::steady_clock::now() >= deadline) {
+			return noKey;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	int key = _getch();
+	// arrows and function keys come as a prefix and a second code, neither of which is a key we use
+	if (key == 0 || key == 0xE0) {
+		_getch();
+		return noKey;
+	}
+	return key == 3 || key == 26 ? endOfInput : key;
+}
+
+#else
+
+#include <csignal>
+#include <cstdlib>
+#include <cerrno>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+	termios savedSettings;
+	volatile std::sig_atomic_t settingsSaved = 0;
+	const int restoredSignals[] = { SIGINT, SIGTERM, SIGHUP, SIGQUIT };
+
+	void restoreTerminal() {
+		if (settingsSaved) {
+			tcsetattr(STDIN_FILENO, TCSANOW, &savedSettings);
+			settingsSaved = 0;
+		}
+	}
+
+	// tcsetattr is async-signal-safe, after it the signal is raised again with its default action
+	void restoreAndRaise(int signal) {
+		restoreTerminal();
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+}
+
+Keyboard::Keyboard() {
+	if (replay::isReplaying() || !isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedSettings) != 0) {
+		return;
+	}
+	termios settings = savedSettings;
+	// keys arrive one at a time without echo, Ctrl+C still sends SIGINT
+	settings.c_lflag &= ~(ICANON | ECHO);
+	settings.c_cc[VMIN] = 1;
+	settings.c_cc[VTIME] = 0;
+	if (tcsetattr(STDIN_FILENO, TCSANOW, &settings) != 0) {
+		return;
+	}
+	settingsSaved = 1;
+	raw = true;
+
+	static bool handlersInstalled = false;
+	if (!handlersInstalled) {
+		handlersInstalled = true;
+		std::atexit(restoreTerminal);
+		for (int signal : restoredSignals) {
+			std::signal(signal, restoreAndRaise);
+		}
+	}
+}
+
+Keyboard::~Keyboard() {
+	if (raw) {
+		restoreTerminal();
+	}
+}
+
+int Keyboard::readKey(int timeoutMs) {
+	if (replay::isReplaying()) {
+		return replay::nextKey(timeoutMs);
+	}
+	int key = readTerminal(timeoutMs);
+	if (replay::isRecording()) {
+		replay::recordKey(key);
+	}
+	return key;
+}
+
+int Keyboard::readTerminal(int timeoutMs) {
+	if (!raw) {
+		// nothing buffered, so wait on the descriptor, which also works on a pipe, rather than return at once
+		if (timeoutMs >= 0 && std::cin.rdbuf()->in_avail() <= 0) {
+			pollfd input{ STDIN_FILENO, POLLIN, 0 };
+			int ready;
+			do {
+				ready = poll(&input, 1, timeoutMs);
+			} while (ready < 0 && errno == EINTR);
+			if (ready == 0) {
+				return noKey;
+			}
+		}
+		int key = std::cin.get();
+		return std::cin ? key : endOfInput;
+	}
+
+	pollfd input{ STDIN_FILENO, POLLIN, 0 };
+	while (true) {
+		int ready = poll(&input, 1, timeoutMs);
+		if (ready < 0 && errno == EINTR) {
+			continue;
+		}
+		if (ready == 0) {
+			return noKey;
+		}
+		unsigned char key;
+		ssize_t received = read(STDIN_FILENO, &key, 1);
+		if (received < 0 && errno == EINTR) {
+			continue;
+		}
+		return received == 1 ? key : endOfInput;
+	}
+}
+
+#endif
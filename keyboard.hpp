@@ -0,0 +1,38 @@
+#ifndef KEYBOARD_HPP
+#define KEYBOARD_HPP
+
+/**
+* @brief reads single keystrokes from the terminal without waiting for Enter
+* While a Keyboard exists the terminal is in non-canonical mode with echo off, and it is put back when the
+* Keyboard is destroyed, when the program exits or when it is stopped by SIGINT, SIGTERM, SIGHUP or SIGQUIT.
+* When stdin is not a terminal, as when input is piped in, keys are taken from std::cin one character at a time
+* and a read with a timeout only returns what std::cin already holds. On Windows keys come from _getch().
+* Keys are written to the recording or taken from the replay when the replay namespace has one running.
+*/
+class Keyboard {
+	public:
+		static const int noKey = 0;
+		static const int endOfInput = -1;
+		Keyboard();
+		~Keyboard();
+		Keyboard(const Keyboard&) = delete;
+		Keyboard& operator=(const Keyboard&) = delete;
+		/**
+		* @param timeoutMs, how long to wait for a key, -1 to wait until one is pressed
+		* @return the key, noKey if none came in time or endOfInput once stdin is closed
+		*/
+		int readKey(int timeoutMs = -1);
+		/**
+		* @return true if the terminal was switched to raw mode
+		*/
+		bool isRaw() const { return raw; }
+		/**
+		* @return the square (1-9) a key names, or -1
+		*/
+		static int toSquareNum(int key) { return key >= '1' && key <= '9' ? key - '0' : -1; }
+	private:
+		int readTerminal(int timeoutMs);
+		bool raw = false;
+};
+
+#endif
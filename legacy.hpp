@@ -0,0 +1,20 @@
+#ifndef LEGACY_HPP
+#define LEGACY_HPP
+
+#include <utility>
+
+/**
+* Entry points into the original free-function engine in main_old.cpp.
+* Nothing plays with it anymore, it is kept as the reference newer engines are checked against.
+*/
+namespace legacy {
+	int evaluateBoard(char (&board)[3][3]);
+	int minimax(char (&board)[3][3], bool isMax, int depth);
+	std::pair<int, int> findBestMove(char (&board)[3][3]);
+	/**
+	* @brief turns the per-node board dump to log.txt on or off, it is on by default
+	*/
+	void setDebugLogging(bool enabled);
+}
+
+#endif
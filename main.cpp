@@ -1,16 +1,310 @@
 #include <iostream>
+#include <fstream>
+#include <cstdlib>
 #include <chrono>
 #include <thread>
+#include <string>
+#include <vector>
+#include "allocations.hpp"
+#include "annotator.hpp"
+#include "coordinator.hpp"
 #include "game.hpp"
+#include "harness.hpp"
+#include "keyboard.hpp"
+#include "multiplexer.hpp"
+#include "policies.hpp"
+#include "profiler.hpp"
+#include "qubic.hpp"
+#include "replay.hpp"
+#include "session.hpp"
+#include "trainer.hpp"
+#include "tournament.hpp"
+#include "tuner.hpp"
+#include "unbounded.hpp"
+#include "tracer.hpp"
+#include "transposition.hpp"
+#include "spectator.hpp"
 
-int main(void) {
+int main(int argc, char* argv[]) {
 
 	Renderer renderer;
+
+	while (argc > 2) {
+		// tic-tac-toe --shared-table name [mode ...]
+		// every engine in this process then caches its searches in a table shared with the other processes using that name
+		if (std::string(argv[1]) == "--shared-table") {
+			std::shared_ptr<TranspositionTable> table = TranspositionTable::attachShared(argv[2], 1 << 20);
+			if (!table) {
+				std::cerr << "Could not attach to shared table " << argv[2] << ", it may belong to an incompatible engine build." << std::endl;
+				return 1;
+			}
+			Engine::setDefaultTranspositionTable(table);
+		}
+		// tic-tac-toe --cache cache.bin [mode ...]
+		// engines start with the search results saved in the file, which is written back every minute and on exit
+		else if (std::string(argv[1]) == "--cache") {
+			std::shared_ptr<TranspositionTable> table = Engine::getDefaultTranspositionTable();
+			if (!table) {
+				table = std::make_shared<TranspositionTable>(1 << 20);
+				Engine::setDefaultTranspositionTable(table);
+			}
+			if (!table->load(argv[2]) && std::ifstream(argv[2])) {
+				std::cerr << argv[2] << " is not a search cache from this engine build, starting with an empty cache." << std::endl;
+			}
+			TranspositionTable::persist(table, argv[2]);
+		}
+		// tic-tac-toe --record keys.txt
+		// saves every key typed, with its time, for --replay
+		else if (std::string(argv[1]) == "--record") {
+			if (!replay::startRecording(argv[2])) {
+				std::cerr << "Could not write " << argv[2] << std::endl;
+				return 1;
+			}
+		}
+		// tic-tac-toe --replay keys.txt [paced]
+		// plays the recorded keys through the interactive game with its output counted rather than shown
+		else if (std::string(argv[1]) == "--replay") {
+			if (!replay::startReplay(argv[2], argc > 3 && std::string(argv[3]) == "paced")) {
+				std::cerr << argv[2] << " is not a key recording" << std::endl;
+				return 1;
+			}
+			// the turn latencies are meant to time the engine, not the pause that makes it look like it is thinking
+			Engine::setDefaultArtificialDelay(0);
+			if (argc > 3 && std::string(argv[3]) == "paced") {
+				argc--;
+				argv++;
+			}
+		}
+		// tic-tac-toe --trace trace.json [mode ...]
+		// records a timeline of turns, frames, prompts and searches, written when the program exits
+		else if (std::string(argv[1]) == "--trace") {
+			tracer::start(argv[2]);
+		}
+		else {
+			break;
+		}
+		argc -= 2;
+		argv += 2;
+	}
+
+	// tic-tac-toe --spectate [workers] [seconds]
+	if (argc > 1 && std::string(argv[1]) == "--spectate") {
+		int workers = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+		int seconds = argc > 3 ? std::atoi(argv[3]) : 0;
+		Spectator spectator(renderer, workers);
+		spectator.run(seconds);
+		return 0;
+	}
+
+	// tic-tac-toe --selfplay [games] [minimax|table|random] [minimax|table|random]
+	if (argc > 1 && std::string(argv[1]) == "--selfplay") {
+		int games = argc > 2 ? std::atoi(argv[2]) : 1000;
+		runSelfPlay(games, argc > 3 ? argv[3] : "table", argc > 4 ? argv[4] : "random");
+		return 0;
+	}
+
+	// tic-tac-toe --multiplex [games] [bot games]
+	if (argc > 1 && std::string(argv[1]) == "--multiplex") {
+		runMultiplexed(argc > 2 ? std::atoi(argv[2]) : 10000, argc > 3 ? std::atoi(argv[3]) : 16);
+		return 0;
+	}
+
+	// tic-tac-toe --train [episodes] [threads] [file]
+	if (argc > 1 && std::string(argv[1]) == "--train") {
+		long long episodes = argc > 2 ? std::atoll(argv[2]) : 1000000;
+		int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+		std::string filename = argc > 4 ? argv[4] : "values.bin";
+
+		ValueTable table;
+		table.load(filename);
+		Trainer trainer(table);
+		double episodesPerSecond = trainer.train(episodes, threads);
+		if (!table.save(filename)) {
+			std::cerr << "Failed to write " << filename << std::endl;
+			return 1;
+		}
+		std::cout << episodes << " episodes at " << static_cast<long long>(episodesPerSecond)
+			<< " episodes/s, saved to " << filename << std::endl;
+		return 0;
+	}
+
+	// tic-tac-toe --tune [games] [threads] [size] [win length] [header]
+	if (argc > 1 && std::string(argv[1]) == "--tune") {
+		long long games = argc > 2 ? std::atoll(argv[2]) : 2000;
+		int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+		int size = argc > 4 ? std::atoi(argv[4]) : 9;
+		int winLength = argc > 5 ? std::atoi(argv[5]) : 5;
+		std::string filename = argc > 6 ? argv[6] : "evaluation_weights.hpp";
+
+		WeightTuner tuner(size, winLength);
+		double positionsPerSecond = tuner.generate(games, threads);
+		std::cout << tuner.getSampleCount() << " positions from " << games << " games at "
+			<< static_cast<long long>(positionsPerSecond) << " positions/s" << std::endl;
+		std::pair<double, double> loss = tuner.fit(1000, threads);
+		std::cout << "loss " << loss.first << " -> " << loss.second << std::endl;
+		if (!tuner.writeHeader(filename)) {
+			std::cerr << "Could not write " << filename << std::endl;
+			return 1;
+		}
+		std::cout << "weights written to " << filename << ", rebuild for the engine to use them" << std::endl;
+		return 0;
+	}
+
+	// tic-tac-toe --verify
+	if (argc > 1 && std::string(argv[1]) == "--verify") {
+		return runDifferentialHarness();
+	}
+
+	// tic-tac-toe --tournament [games per pairing] [threads] [config ...]
+	if (argc > 1 && std::string(argv[1]) == "--tournament") {
+		int games = argc > 2 ? std::atoi(argv[2]) : 100;
+		int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+		std::vector<std::string> names(argv + (argc > 4 ? 4 : argc), argv + argc);
+		if (names.empty()) {
+			names = { "minimax", "time1ms", "depth3", "depth2", "depth1", "random" };
+		}
+
+		std::vector<TournamentConfig> configs;
+		for (const std::string& name : names) {
+			TournamentConfig config;
+			if (!parseTournamentConfig(name, config)) {
+				std::cerr << "Unknown engine configuration " << name << ", use minimax, depthN, timeNms, nodesN or random." << std::endl;
+				return 1;
+			}
+			configs.push_back(config);
+		}
+
+		Tournament tournament(configs, games);
+		double elapsed = tournament.run(threads);
+		tournament.writeReport(std::cout);
+		std::cout << "played in " << static_cast<long>(elapsed * 1000) << " ms" << std::endl;
+		return 0;
+	}
+
+	// tic-tac-toe --annotate games.txt [annotations.txt] [threads]
+	if (argc > 2 && std::string(argv[1]) == "--annotate") {
+		std::ifstream input(argv[2]);
+		if (!input) {
+			std::cerr << "Could not open " << argv[2] << std::endl;
+			return 1;
+		}
+		std::ofstream output;
+		if (argc > 3) {
+			output.open(argv[3]);
+			if (!output) {
+				std::cerr << "Could not write " << argv[3] << std::endl;
+				return 1;
+			}
+		}
+		int threads = argc > 4 ? std::atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+
+		// the workers share one table, so a position reached in many games is only searched once
+		Engine engine(0, false);
+		engine.setTranspositionTable(std::make_shared<TranspositionTable>(1 << 16));
+		BatchAnnotator annotator(engine, threads);
+
+		auto startTime = std::chrono::steady_clock::now();
+		long long games = annotator.run(input, argc > 3 ? output : std::cout);
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		writePlayerStats(annotator.getPlayerStats(), std::cout);
+		std::cout << games << " games annotated in " << static_cast<long>(elapsed * 1000) << " ms" << std::endl;
+		return 0;
+	}
+
+	// tic-tac-toe --shards [shards] [games per shard] [records file]
+	if (argc > 1 && std::string(argv[1]) == "--shards") {
+		int shards = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+		unsigned long games = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10000;
+		return runShardedSelfPlay(shards, static_cast<std::uint32_t>(games), argc > 4 ? argv[4] : "shard_games.txt");
+	}
+
+	// tic-tac-toe --qubic [first | selfplay [games]]
+	if (argc > 1 && std::string(argv[1]) == "--qubic") {
+		std::string option = argc > 2 ? argv[2] : "";
+		if (option == "selfplay") {
+			runQubicSelfPlay(argc > 3 ? std::atoi(argv[3]) : 1);
+		}
+		else {
+			playQubic(renderer, option == "first");
+		}
+		return 0;
+	}
+
+	// tic-tac-toe --unbounded [win length] [first | selfplay [games]]
+	if (argc > 1 && std::string(argv[1]) == "--unbounded") {
+		int winLength = argc > 2 ? std::atoi(argv[2]) : 5;
+		std::string option = argc > 3 ? argv[3] : "";
+		if (winLength < 3 || winLength > SparseBoard::maxWinLength) {
+			std::cerr << "The win length has to be from 3 to " << SparseBoard::maxWinLength << "." << std::endl;
+			return 1;
+		}
+		if (option == "selfplay") {
+			runUnboundedSelfPlay(winLength, argc > 4 ? std::atoi(argv[4]) : 1);
+		}
+		else {
+			playUnbounded(renderer, winLength, option == "first");
+		}
+		return 0;
+	}
+
+	// tic-tac-toe --prove [size] [win length] [max nodes]
+	if (argc > 1 && std::string(argv[1]) == "--prove") {
+		int size = argc > 2 ? std::atoi(argv[2]) : 4;
+		int winLength = argc > 3 ? std::atoi(argv[3]) : size;
+		std::size_t maxNodes = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 50000000;
+		Engine engine(0, false);
+
+		auto startTime = std::chrono::steady_clock::now();
+		ProofResult proof = engine.prove(Board(size, winLength), 'X', maxNodes);
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		const char* outcomes[] = { "a win for X", "a win for O", "a draw", "unknown" };
+		std::cout << size << "x" << size << " with " << winLength << " in a row is " << outcomes[proof.outcome]
+			<< " (proof tree " << (proof.proofTreeExact ? "" : "at least ") << proof.proofTreeSize << " positions, " << proof.nodesSearched << " nodes, "
+			<< static_cast<long>(elapsed * 1000) << " ms)";
+		if (proof.move.first >= 0) {
+			std::cout << ", X plays row " << proof.move.first + 1 << " column " << proof.move.second + 1;
+		}
+		std::cout << std::endl;
+		return 0;
+	}
+
+	// tic-tac-toe --sessions [count]
+	if (argc > 1 && std::string(argv[1]) == "--sessions") {
+		unsigned long count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+		Engine engine(0, false);
+		SessionStore store(static_cast<std::uint32_t>(count), engine);
+
+		auto startTime = std::chrono::steady_clock::now();
+		for (unsigned long i = 0; i < count; i++) {
+			SessionHandle handle = store.create(false, true);
+			store.play(handle, static_cast<int>(i % 9) + 1);
+		}
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		std::cout << store.getActiveCount() << " sessions hold "
+			<< store.getMemoryUsage() / (1024 * 1024) << " MB ("
+			<< sizeof(SessionRecord) << " bytes each), created in "
+			<< static_cast<long>(elapsed * 1000) << " ms" << std::endl;
+		return 0;
+	}
+
+	// send SIGUSR1 to append the latency summary so far to latency.txt, it is also written on exit
+	profiler::installSignalHandler();
+
 	renderer.renderStartingScreen();
-	std::cin.get();
+	{
+		Keyboard keyboard;
+		keyboard.readKey();
+	}
 
 	Game game(false, renderer);
 	game.displayStartingScreen();
 
+	profiler::dumpSummary("latency.txt");
+	// only written when built with TTT_TRACK_ALLOCATIONS
+	allocations::dumpReport("allocations.txt");
+
 	return 0;
-}
\ No newline at end of file
+}
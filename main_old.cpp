@@ -21,6 +21,7 @@
 #include <thread>
 #include <chrono>
 #include <fstream>
+#include "legacy.hpp"
 
 enum UpdateStatus {
     success,
@@ -49,6 +50,7 @@ static void printRepeatedChar(std::string c, int n);
 static void logDebugState(std::pair<int, int> position, char board[3][3], int depth, int score);
 
 std::ofstream log_file("log.txt");
+static bool debugLogging = true;
 
 int main_old() {
     printTitle();
@@ -403,6 +405,9 @@ static void printMenuScreen() {
 }
 
 static void logDebugState(std::pair<int, int> position, char board[3][3], int depth, int score) {
+    if (!debugLogging) {
+        return;
+    }
     if (depth == 0) {
         log_file << "-------------------------------------------------------------------\n";
     }
@@ -425,6 +430,24 @@ static void logDebugState(std::pair<int, int> position, char board[3][3], int de
     }
 }
 
+namespace legacy {
+    int evaluateBoard(char (&board)[3][3]) {
+        return ::evaluateBoard(board);
+    }
+
+    int minimax(char (&board)[3][3], bool isMax, int depth) {
+        return ::minimax(board, isMax, depth);
+    }
+
+    std::pair<int, int> findBestMove(char (&board)[3][3]) {
+        return ::findBestMove(board);
+    }
+
+    void setDebugLogging(bool enabled) {
+        debugLogging = enabled;
+    }
+}
+
 //static void drawFrame(const std::string& title) {
 //    const int width = 60;
 //
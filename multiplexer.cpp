@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "multiplexer.hpp"
+
+namespace {
+	// a search mostly sleeps through the artificial delay, so a game gets a thread of its own up to this many
+	const int maxEngineThreads = 64;
+}
+
+std::string InputChannel::Awaiter::await_resume() {
+	channel.hasInput = false;
+	return std::move(channel.input);
+}
+
+void InputChannel::push(const std::string& text) {
+	input = text;
+	hasInput = true;
+	if (waiting) {
+		std::coroutine_handle<> handle = waiting;
+		waiting = nullptr;
+		handle.resume();
+	}
+}
+
+EngineQueue::EngineQueue(int threadCount) {
+	for (int i = 0; i < std::max(threadCount, 1); i++) {
+		threads.emplace_back(&EngineQueue::work, this);
+	}
+}
+
+EngineQueue::~EngineQueue() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobReady.notify_all();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+void EngineQueue::submit(Awaiter& awaiter, std::coroutine_handle<> handle) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back({ &awaiter, handle });
+		pending++;
+	}
+	jobReady.notify_one();
+}
+
+void EngineQueue::work() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+		if (stopping) {
+			return;
+		}
+		Job job = jobs.front();
+		jobs.pop_front();
+		lock.unlock();
+		// the game's coroutine is suspended, so nothing else touches the game until it is resumed
+		job.awaiter->squareNum = job.awaiter->game.findComputerMove();
+		lock.lock();
+		done.push_back(job);
+		jobDone.notify_one();
+	}
+}
+
+int EngineQueue::resumeFinished(bool wait) {
+	int resumed = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	if (wait) {
+		jobDone.wait(lock, [this] { return pending == 0 || !done.empty(); });
+	}
+	while (!done.empty()) {
+		Job job = done.front();
+		done.pop_front();
+		pending--;
+		// the coroutine may submit its next search, which takes the lock
+		lock.unlock();
+		job.handle.resume();
+		resumed++;
+		lock.lock();
+	}
+	return resumed;
+}
+
+GameTask::GameTask(GameTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+GameTask& GameTask::operator=(GameTask&& other) noexcept {
+	if (this != &other) {
+		if (handle) {
+			handle.destroy();
+		}
+		handle = std::exchange(other.handle, nullptr);
+	}
+	return *this;
+}
+
+GameTask::~GameTask() {
+	if (handle) {
+		handle.destroy();
+	}
+}
+
+GameTask runGame(Game& game, InputChannel& input, EngineQueue& engines) {
+	Game::StepResult result = game.reset();
+	while (result.state != Game::gameOver) {
+		if (result.effects & Game::runComputerMove) {
+			int squareNum = co_await engines.findMove(game);
+			result = game.playComputerMove(squareNum);
+		}
+		else {
+			std::string text = co_await input.next();
+			result = game.step(text);
+		}
+	}
+}
+
+void runMultiplexed(int games, int botGames) {
+	Renderer renderer;
+	int total = games + botGames;
+	std::vector<std::unique_ptr<Game>> sessions;
+	std::vector<InputChannel> channels(total);
+	std::vector<GameTask> tasks;
+	sessions.reserve(total);
+	tasks.reserve(total);
+	EngineQueue engines(std::min(botGames, maxEngineThreads));
+
+	for (int i = 0; i < total; i++) {
+		// the games against the computer take turns at who starts
+		sessions.push_back(i < games ? std::make_unique<Game>(renderer) : std::make_unique<Game>((i - games) % 2 == 0, renderer));
+		tasks.push_back(runGame(*sessions[i], channels[i], engines));
+	}
+
+	// one in ten key presses is not a digit, so the error path gets exercised too
+	const std::string keys = "123456789a";
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> randomKey(0, static_cast<int>(keys.length()) - 1);
+
+	long long steps = 0;
+	int running = total;
+	auto startTime = std::chrono::steady_clock::now();
+	double humanGamesTime = 0;
+
+	while (running > 0) {
+		running = 0;
+		int humanRunning = 0;
+		bool typed = false;
+		for (int i = 0; i < total; i++) {
+			if (!tasks[i].isDone() && channels[i].isWaiting()) {
+				channels[i].push(std::string(1, keys[randomKey(rng)]));
+				steps++;
+				typed = true;
+			}
+			if (!tasks[i].isDone()) {
+				running++;
+				humanRunning += i < games;
+			}
+		}
+		if (humanRunning == 0 && humanGamesTime == 0) {
+			humanGamesTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		}
+		// with no game waiting for a key there is nothing to do but wait for a search
+		steps += engines.resumeFinished(!typed);
+	}
+
+	auto report = [&](const char* kind, int first, int last) {
+		int xWins = 0, oWins = 0, ties = 0;
+		for (int i = first; i < last; i++) {
+			char winner = sessions[i]->getWinner();
+			if (winner == 'X') xWins++;
+			else if (winner == 'O') oWins++;
+			else ties++;
+		}
+		std::cout << "  " << last - first << " " << kind << ": " << xWins << " X wins, " << oWins << " O wins, " << ties << " ties" << std::endl;
+	};
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	std::cout << total << " games interleaved on one thread, "
+		<< steps << " steps in " << static_cast<long>(elapsed * 1000) << " ms ("
+		<< static_cast<long long>(elapsed > 0 ? steps / elapsed : 0) << " steps/s)" << std::endl;
+	report("player-vs-player games", 0, games);
+	report("games against the computer", games, total);
+	std::cout << "the player-vs-player games were done after " << static_cast<long>(humanGamesTime * 1000)
+		<< " ms, the computer's searches never held them up" << std::endl;
+}
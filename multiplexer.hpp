@@ -0,0 +1,123 @@
+#ifndef MULTIPLEXER_HPP
+#define MULTIPLEXER_HPP
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game.hpp"
+
+/**
+* @brief hands the text typed for one game to the coroutine that is waiting for it
+*/
+class InputChannel {
+	public:
+		struct Awaiter {
+			InputChannel& channel;
+			bool await_ready() const { return channel.hasInput; }
+			void await_suspend(std::coroutine_handle<> handle) { channel.waiting = handle; }
+			std::string await_resume();
+		};
+		/**
+		* @brief co_await the result to suspend until push() is called
+		*/
+		Awaiter next() { return Awaiter{ *this }; }
+		/**
+		* @brief stores the input and resumes the waiting coroutine, which runs until it needs input again
+		*/
+		void push(const std::string& text);
+		bool isWaiting() const { return static_cast<bool>(waiting); }
+	private:
+		std::string input;
+		bool hasInput = false;
+		std::coroutine_handle<> waiting;
+};
+
+/**
+* @brief runs the computer moves of multiplexed games on a pool of threads and hands them back to the driving thread
+* A game coroutine co_awaits findMove() and stays suspended while a worker runs Game::findComputerMove(). The
+* finished search goes on a completion queue, and resumeFinished() resumes its coroutine on the driving thread,
+* so a game is only ever stepped there and a search, artificial delay included, holds up no other game.
+*/
+class EngineQueue {
+	public:
+		struct Awaiter {
+			EngineQueue& queue;
+			Game& game;
+			int squareNum = -1;
+			bool await_ready() const { return false; }
+			void await_suspend(std::coroutine_handle<> handle) { queue.submit(*this, handle); }
+			int await_resume() const { return squareNum; }
+		};
+		explicit EngineQueue(int threadCount);
+		~EngineQueue();
+		EngineQueue(const EngineQueue&) = delete;
+		EngineQueue& operator=(const EngineQueue&) = delete;
+		/**
+		* @brief co_await the result to suspend until a worker has found the computer's move in game
+		* @return the square for Game::playComputerMove()
+		*/
+		Awaiter findMove(Game& game) { return Awaiter{ *this, game }; }
+		/**
+		* @brief resumes, on this thread, every coroutine whose search has finished
+		* @param wait, block until a search finishes if none has and one is still running
+		* @return how many coroutines were resumed
+		*/
+		int resumeFinished(bool wait);
+	private:
+		struct Job {
+			Awaiter* awaiter;
+			std::coroutine_handle<> handle;
+		};
+		void submit(Awaiter& awaiter, std::coroutine_handle<> handle);
+		void work();
+		std::mutex mutex;
+		std::condition_variable jobReady;
+		std::condition_variable jobDone;
+		std::deque<Job> jobs;
+		std::deque<Job> done;
+		// jobs submitted and not yet resumed
+		int pending = 0;
+		bool stopping = false;
+		std::vector<std::thread> threads;
+};
+
+/**
+* @brief a running game coroutine, the coroutine frame is destroyed along with the task
+*/
+class GameTask {
+	public:
+		struct promise_type {
+			GameTask get_return_object() { return GameTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() { throw; }
+		};
+		GameTask(GameTask&& other) noexcept;
+		GameTask& operator=(GameTask&& other) noexcept;
+		GameTask(const GameTask&) = delete;
+		GameTask& operator=(const GameTask&) = delete;
+		~GameTask();
+		bool isDone() const { return !handle || handle.done(); }
+	private:
+		explicit GameTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+		std::coroutine_handle<promise_type> handle;
+};
+
+/**
+* @brief drives game with Game::step(), suspending whenever a human has to type a move or the computer is thinking
+* The computer's search runs on engines, so one thread can interleave any number of games whatever they wait on.
+*/
+GameTask runGame(Game& game, InputChannel& input, EngineQueue& engines);
+
+/**
+* @brief plays player-vs-player games and games against the computer on this thread, all interleaved, with random
+* key presses as the human input and the computer's searches on a pool of threads
+*/
+void runMultiplexed(int games, int botGames);
+
+#endif
@@ -1,7 +1,5 @@
-#include <iostream>
-#include <regex>
 #include "player.hpp"
-#include "engine.hpp"
+#include "tracer.hpp"
 #include "utils.hpp"
 
 Player::Player() : type(HUMAN_X), name("Player 1"), symbol('X') {}
@@ -31,20 +29,27 @@ Player::Player(PlayerType playertype) : type(playertype) {
 }
 
 HumanPlayer::HumanPlayer(char symbol) : Player((symbol == 'X' ? HUMAN_X : HUMAN_O)) {}
-int HumanPlayer::prompt(Board board, Renderer &renderer, std::string promptMessage) {
-	int squareNum{};
+int HumanPlayer::prompt(const Board& board, Renderer& renderer, std::string_view promptMessage) {
+	tracer::Span span("HumanPlayer::prompt", "player");
+	return HumanPolicy(renderer, promptMessage.length()).chooseMove(board, symbol);
+}
 
-	std::string input = renderer.prompt(promptMessage.length());
-	std::regex pattern("^[1-9]$");
-	if (!std::regex_match(input, pattern)) {
-		return -1;
-	}
-	squareNum = std::stoi(input);
-	return squareNum;
+ComputerPlayer::ComputerPlayer(char symbol) : Player((symbol == 'X' ? COMPUTER_X : COMPUTER_O)), policy(Engine()) {}
+int ComputerPlayer::prompt(const Board& board, Renderer& renderer, std::string_view promptMessage) {
+	tracer::Span span("ComputerPlayer::prompt", "player");
+	return policy.chooseMove(board, symbol);
 }
 
-ComputerPlayer::ComputerPlayer(char symbol) : Player((symbol == 'X' ? COMPUTER_X : COMPUTER_O)), engine() {}
-int ComputerPlayer::prompt(Board board, Renderer &renderer, std::string promptMessage) {
-	std::pair<int, int> move = engine.findBestMove(board);
-	return utils::getSquareNum(move.first, move.second);
+LearnedPlayer::LearnedPlayer(const std::string& filename, char symbol) : Player((symbol == 'X' ? COMPUTER_X : COMPUTER_O)), policy(loadTable(filename)) {}
+int LearnedPlayer::prompt(const Board& board, Renderer& renderer, std::string_view promptMessage) {
+	tracer::Span span("LearnedPlayer::prompt", "player");
+	return policy.chooseMove(board, symbol);
+}
+
+std::shared_ptr<const ValueTable> LearnedPlayer::loadTable(const std::string& filename) {
+	auto table = std::make_shared<ValueTable>();
+	if (!table->load(filename)) {
+		utils::log("log.txt", "Failed to load value table: " + filename, true);
+	}
+	return table;
 }
\ No newline at end of file
@@ -2,12 +2,11 @@
 #define PLAYER_HPP
 
 #include <string>
+#include <string_view>
 #include "board.hpp"
-#include "engine.hpp"
+#include "policies.hpp"
 #include "renderer.hpp"
 
-class Engine;
-
 enum PlayerType {
 	HUMAN_X,
 	HUMAN_O,
@@ -20,8 +19,8 @@ class Player {
 		Player();
 		Player(PlayerType playertype);
 		virtual ~Player() = default;
-		virtual int prompt(Board board, Renderer& renderer, std::string promptMessage) = 0;
-		std::string getName() const { return name; }
+		virtual int prompt(const Board& board, Renderer& renderer, std::string_view promptMessage) = 0;
+		const std::string& getName() const { return name; }
 		virtual bool isComputer() const { return false; }
 		char getSymbol() const { return symbol; }
 	protected:
@@ -33,17 +32,31 @@ class Player {
 class HumanPlayer : public Player {
 	public:
 		HumanPlayer(char symbol = 'X');
-		int prompt(Board board, Renderer &renderer, std::string promptMessage) override;
+		int prompt(const Board& board, Renderer& renderer, std::string_view promptMessage) override;
 
 };
 
 class ComputerPlayer : public Player {
 	public:
 		ComputerPlayer(char symbol = 'O');
-		int prompt(Board board, Renderer& renderer, std::string promptMessage) override;
+		int prompt(const Board& board, Renderer& renderer, std::string_view promptMessage) override;
+		bool isComputer() const override { return true; }
+	private:
+		MinimaxPolicy policy;
+
+};
+
+class LearnedPlayer : public Player {
+	public:
+		/**
+		* @param filename, a value table checkpoint written by the Trainer
+		*/
+		LearnedPlayer(const std::string& filename, char symbol = 'O');
+		int prompt(const Board& board, Renderer& renderer, std::string_view promptMessage) override;
 		bool isComputer() const override { return true; }
 	private:
-		Engine engine;
+		static std::shared_ptr<const ValueTable> loadTable(const std::string& filename);
+		LearnedPolicy policy;
 
 };
 
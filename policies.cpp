@@ -0,0 +1,158 @@
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include "keyboard.hpp"
+#include "policies.hpp"
+#include "utils.hpp"
+
+namespace {
+	const int positionCount = Board::codeCount;
+	const signed char unknown = 127;
+	const int powersOfThree[9] = { 1, 3, 9, 27, 81, 243, 729, 2187, 6561 };
+
+	struct SolvedTable {
+		std::array<signed char, positionCount * 2> values;
+		std::array<signed char, positionCount * 2> bestSquares;
+	};
+
+	/**
+	* @brief returns the same score as Engine::minimax(board, xToMove, 0) and records the move Engine::findBestMove would pick
+	* Scores only shift by one per ply, so the score of a child seen from its parent is just adjusted rather than searched again.
+	*/
+	signed char solve(SolvedTable& table, Board& board, int code, bool xToMove) {
+		int index = code * 2 + (xToMove ? 1 : 0);
+		if (table.values[index] != unknown) {
+			return table.values[index];
+		}
+
+		int eval = board.evaluate();
+		signed char bestValue = 0;
+		signed char bestSquare = -1;
+
+		if (eval == 0 && board.isMovesLeft()) {
+			char symbol = xToMove ? 'X' : 'O';
+			int bestChild = xToMove ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min();
+
+			for (int square = 0; square < 9; square++) {
+				int row = square / 3;
+				int col = square % 3;
+				if (board.getCell(row, col) != ' ') {
+					continue;
+				}
+				board.setCell(row, col, symbol);
+				int childValue = solve(table, board, code + (xToMove ? 1 : 2) * powersOfThree[square], !xToMove);
+				board.setCell(row, col, ' ');
+
+				if ((xToMove && childValue <= bestChild) || (!xToMove && childValue >= bestChild)) {
+					bestChild = childValue;
+					bestSquare = static_cast<signed char>(square + 1);
+				}
+			}
+			bestValue = static_cast<signed char>(bestChild > 0 ? bestChild - 1 : bestChild < 0 ? bestChild + 1 : 0);
+		}
+		else {
+			bestValue = static_cast<signed char>(eval);
+		}
+
+		table.values[index] = bestValue;
+		table.bestSquares[index] = bestSquare;
+		return bestValue;
+	}
+
+	const SolvedTable& solvedTable() {
+		static const SolvedTable table = [] {
+			SolvedTable result;
+			result.values.fill(unknown);
+			result.bestSquares.fill(-1);
+			for (int code = 0; code < positionCount; code++) {
+				Board board = Board::fromCode(code);
+				solve(result, board, code, true);
+				solve(result, board, code, false);
+			}
+			return result;
+		}();
+		return table;
+	}
+
+	template <typename F>
+	void withBotPolicy(const std::string& name, unsigned seed, F f) {
+		if (name == "minimax") {
+			MinimaxPolicy policy;
+			f(policy);
+		}
+		else if (name == "table") {
+			TableLookupPolicy policy;
+			f(policy);
+		}
+		else if (name == "learned") {
+			auto table = std::make_shared<ValueTable>();
+			if (!table->load("values.bin")) {
+				std::cerr << "Could not load values.bin, the learned player will play untrained." << std::endl;
+			}
+			LearnedPolicy policy(table);
+			f(policy);
+		}
+		else {
+			RandomPolicy policy(seed);
+			f(policy);
+		}
+	}
+}
+
+int MinimaxPolicy::chooseMove(const Board& board, char symbol) {
+	std::pair<int, int> move = engine.findBestMove(board, symbol);
+	return move.first < 0 ? -1 : utils::getSquareNum(move.first, move.second);
+}
+
+TableLookupPolicy::TableLookupPolicy() : bestSquares(solvedTable().bestSquares.data()) {}
+
+int TableLookupPolicy::chooseMove(const Board& board, char symbol) const {
+	// the table is indexed the way Engine::minimax names its sides, X to move is the minimising side
+	return bestSquares[board.toCode() * 2 + (symbol == 'X' ? 1 : 0)];
+}
+
+int RandomPolicy::chooseMove(const Board& board, char /*symbol*/) {
+	int emptySquares[9];
+	int count = 0;
+	for (int square = 0; square < 9; square++) {
+		if (board.getCell(square / 3, square % 3) == ' ') {
+			emptySquares[count++] = square + 1;
+		}
+	}
+	if (count == 0) {
+		return -1;
+	}
+	return emptySquares[std::uniform_int_distribution<int>(0, count - 1)(rng)];
+}
+
+int HumanPolicy::chooseMove(const Board& /*board*/, char /*symbol*/) {
+	return parseSquareNum(renderer.prompt(promptMessageLength));
+}
+
+int HumanPolicy::parseSquareNum(const std::string& input) {
+	return input.size() == 1 ? Keyboard::toSquareNum(input[0]) : -1;
+}
+
+void runSelfPlay(int games, const std::string& xPolicyName, const std::string& oPolicyName) {
+	int xWins = 0, oWins = 0, ties = 0;
+	auto startTime = std::chrono::steady_clock::now();
+
+	withBotPolicy(xPolicyName, 1, [&](auto& xPolicy) {
+		withBotPolicy(oPolicyName, 2, [&](auto& oPolicy) {
+			for (int i = 0; i < games; i++) {
+				Board board;
+				char winner = playGame(board, xPolicy, oPolicy);
+				if (winner == 'X') xWins++;
+				else if (winner == 'O') oWins++;
+				else ties++;
+			}
+		});
+	});
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	std::cout << xPolicyName << " (X) vs " << oPolicyName << " (O): "
+		<< xWins << " X wins, " << oWins << " O wins, " << ties << " ties in "
+		<< static_cast<long>(elapsed * 1000) << " ms ("
+		<< static_cast<long>(elapsed > 0 ? games / elapsed : 0) << " games/s)" << std::endl;
+}
@@ -0,0 +1,109 @@
+#ifndef POLICIES_HPP
+#define POLICIES_HPP
+
+#include <memory>
+#include <random>
+#include <string>
+#include "board.hpp"
+#include "engine.hpp"
+#include "renderer.hpp"
+#include "trainer.hpp"
+
+/**
+* Player policies for playGame(). A policy is any type with
+*     int chooseMove(const Board& board, char symbol);
+* returning a square number from 1 to 9. Because playGame() takes the policies as template
+* parameters, bot-vs-bot games compile down to direct calls with no virtual dispatch,
+* no prompt strings and no Renderer.
+*/
+
+/**
+* @brief perfect play by searching the position with Engine::minimax on every move
+*/
+class MinimaxPolicy {
+	public:
+		MinimaxPolicy() : engine(0, false) {}
+		explicit MinimaxPolicy(const Engine& engine) : engine(engine) {}
+		int chooseMove(const Board& board, char symbol);
+	private:
+		Engine engine;
+};
+
+/**
+* @brief perfect play by looking up a best move table that is solved once per process
+* Picks the same moves as MinimaxPolicy without searching.
+*/
+class TableLookupPolicy {
+	public:
+		TableLookupPolicy();
+		int chooseMove(const Board& board, char symbol) const;
+	private:
+		const signed char* bestSquares;
+};
+
+class RandomPolicy {
+	public:
+		RandomPolicy(unsigned seed = std::random_device{}()) : rng(seed) {}
+		int chooseMove(const Board& board, char symbol);
+	private:
+		std::mt19937 rng;
+};
+
+/**
+* @brief plays the position with the best learned value from a table written by the Trainer
+*/
+class LearnedPolicy {
+	public:
+		explicit LearnedPolicy(std::shared_ptr<const ValueTable> table) : table(std::move(table)) {}
+		int chooseMove(const Board& board, char symbol) const { return table->chooseMove(board, symbol); }
+	private:
+		std::shared_ptr<const ValueTable> table;
+};
+
+/**
+* @brief reads the move from the terminal through the renderer
+*/
+class HumanPolicy {
+	public:
+		HumanPolicy(Renderer& renderer, int promptMessageLength = 0)
+			: renderer(renderer), promptMessageLength(promptMessageLength) {}
+		int chooseMove(const Board& board, char symbol);
+		/**
+		* @return the square number typed by the player, or -1 if input is not a single digit from 1 to 9
+		*/
+		static int parseSquareNum(const std::string& input);
+	private:
+		Renderer& renderer;
+		int promptMessageLength;
+};
+
+/**
+* @brief plays one game to the end, invalid moves are simply asked for again
+* @param board, the starting position, left in its final state
+* @param firstSymbol, 'X' or 'O', the side that moves first
+* @return 'X' or 'O' for the winner, 'T' for a tie
+*/
+template <typename XPolicy, typename OPolicy>
+char playGame(Board& board, XPolicy& xPolicy, OPolicy& oPolicy, char firstSymbol = 'X') {
+	char symbol = firstSymbol;
+	int eval = board.evaluate();
+	while (eval == 0 && board.isMovesLeft()) {
+		int squareNum = (symbol == 'X') ? xPolicy.chooseMove(board, 'X') : oPolicy.chooseMove(board, 'O');
+		if (board.updateBoard(squareNum, symbol) != Board::UpdateStatus::success) {
+			continue;
+		}
+		symbol = (symbol == 'X') ? 'O' : 'X';
+		eval = board.evaluate();
+	}
+	if (eval == +10) return 'O';
+	if (eval == -10) return 'X';
+	return 'T';
+}
+
+/**
+* @brief plays games between two named bot policies ("minimax", "table", "learned" or "random") and prints the results
+* "learned" reads its values from values.bin
+*/
+void runSelfPlay(int games, const std::string& xPolicyName, const std::string& oPolicyName);
+
+#endif
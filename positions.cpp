@@ -0,0 +1,82 @@
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "board.hpp"
+#include "positions.hpp"
+
+namespace {
+	const int wordCount = (Board::codeCount + 63) / 64;
+	const int lines[8][3] = { { 0, 1, 2 }, { 3, 4, 5 }, { 6, 7, 8 }, { 0, 3, 6 }, { 1, 4, 7 }, { 2, 5, 8 }, { 0, 4, 8 }, { 2, 4, 6 } };
+
+	struct IndexTables {
+		std::array<std::uint64_t, wordCount> reachable{};
+		// number of reachable codes in the words before this one
+		std::array<std::uint16_t, wordCount> ranks{};
+		std::array<std::uint16_t, PositionIndex::positionCount> codes{};
+		int count = 0;
+	};
+
+	constexpr bool hasLine(const int digits[9], int digit) {
+		for (const auto& line : lines) {
+			if (digits[line[0]] == digit && digits[line[1]] == digit && digits[line[2]] == digit) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// X moves first and play stops at the first line, so X has as many stones as O or one more, and a
+	// completed line belongs to whoever moved last
+	constexpr bool isReachable(int code) {
+		int digits[9] = {};
+		int xCount = 0, oCount = 0;
+		for (int square = 0; square < 9; square++, code /= 3) {
+			digits[square] = code % 3;
+			xCount += digits[square] == 1;
+			oCount += digits[square] == 2;
+		}
+		if (xCount != oCount && xCount != oCount + 1) {
+			return false;
+		}
+		bool xWon = hasLine(digits, 1);
+		bool oWon = hasLine(digits, 2);
+		return !(xWon && oWon) && !(xWon && xCount == oCount) && !(oWon && xCount != oCount);
+	}
+
+	constexpr IndexTables buildIndexTables() {
+		IndexTables tables;
+		for (int code = 0; code < Board::codeCount; code++) {
+			if (code % 64 == 0) {
+				tables.ranks[code / 64] = static_cast<std::uint16_t>(tables.count);
+			}
+			if (isReachable(code)) {
+				tables.reachable[code / 64] |= std::uint64_t(1) << (code % 64);
+				tables.codes[tables.count++] = static_cast<std::uint16_t>(code);
+			}
+		}
+		return tables;
+	}
+
+	constexpr IndexTables indexTables = buildIndexTables();
+	static_assert(indexTables.count == PositionIndex::positionCount, "X-first play reaches 5,478 positions");
+}
+
+int PositionIndex::indexOf(int code) {
+	std::uint64_t word = indexTables.reachable[code >> 6];
+	std::uint64_t bit = std::uint64_t(1) << (code & 63);
+	int rank = indexTables.ranks[code >> 6] + std::popcount(word & (bit - 1));
+	return (word & bit) ? rank : -1;
+}
+
+int PositionIndex::codeOf(int index) {
+	return indexTables.codes[index];
+}
+
+int PositionIndex::swapColours(int code) {
+	int swapped = 0;
+	for (int power = 1; code > 0; code /= 3, power *= 3) {
+		int digit = code % 3;
+		swapped += (digit == 0 ? 0 : 3 - digit) * power;
+	}
+	return swapped;
+}
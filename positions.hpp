@@ -0,0 +1,29 @@
+#ifndef POSITIONS_HPP
+#define POSITIONS_HPP
+
+/**
+* @brief a minimal perfect hash from the 3x3 positions X-first play can reach to a dense index
+* Of the 19,683 Board::toCode() codes only 5,478 can come up in a game X starts, counting finished games. Every
+* reachable code gets an index from 0 to positionCount - 1, so per-position data fits in a contiguous array
+* a quarter of the size of one indexed by code. The tables are built at compile time: a bitmap of reachable
+* codes with the number of reachable codes before each 64 bit word, so a lookup is one load, a mask and a popcount.
+*/
+class PositionIndex {
+	public:
+		static const int positionCount = 5478;
+		/**
+		* @return the index of code, or -1 if X-first play cannot reach it
+		*/
+		static int indexOf(int code);
+		/**
+		* @return the Board::toCode() code of index
+		*/
+		static int codeOf(int index);
+		static bool contains(int code) { return indexOf(code) >= 0; }
+		/**
+		* @return the code of the same board with X and O swapped, which turns a game O started into one X started
+		*/
+		static int swapColours(int code);
+};
+
+#endif
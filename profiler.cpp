@@ -0,0 +1,146 @@
+#include <bit>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include "profiler.hpp"
+
+namespace profiler {
+
+	namespace {
+		std::array<Histogram, phaseCount> histograms;
+		volatile std::sig_atomic_t dumpRequested = 0;
+
+		void requestDump(int) {
+			dumpRequested = 1;
+		}
+
+		void writeDuration(std::ostream& out, std::uint64_t nanoseconds) {
+			out << std::setw(12) << std::fixed << std::setprecision(3) << nanoseconds / 1e6;
+		}
+	}
+
+	int Histogram::bucketIndex(std::uint64_t value) {
+		int magnitude = static_cast<int>(std::bit_width(value));
+		if (magnitude <= subBucketBits + 1) {
+			return static_cast<int>(value);
+		}
+		int shift = magnitude - subBucketBits - 1;
+		return ((shift + 1) << subBucketBits) + static_cast<int>((value >> shift) & ((1 << subBucketBits) - 1));
+	}
+
+	std::uint64_t Histogram::bucketUpperBound(int index) {
+		if (index < (2 << subBucketBits)) {
+			return static_cast<std::uint64_t>(index);
+		}
+		int shift = (index >> subBucketBits) - 1;
+		std::uint64_t lowerBound = static_cast<std::uint64_t>((1 << subBucketBits) + (index & ((1 << subBucketBits) - 1))) << shift;
+		return lowerBound + ((std::uint64_t(1) << shift) - 1);
+	}
+
+	void Histogram::record(std::uint64_t nanoseconds) {
+		buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+		count.fetch_add(1, std::memory_order_relaxed);
+		std::uint64_t currentMax = max.load(std::memory_order_relaxed);
+		while (nanoseconds > currentMax && !max.compare_exchange_weak(currentMax, nanoseconds, std::memory_order_relaxed)) {}
+	}
+
+	void Histogram::merge(const Histogram& other) {
+		for (int i = 0; i < bucketCount; i++) {
+			buckets[i].fetch_add(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		count.fetch_add(other.getCount(), std::memory_order_relaxed);
+		std::uint64_t otherMax = other.getMax();
+		std::uint64_t currentMax = max.load(std::memory_order_relaxed);
+		while (otherMax > currentMax && !max.compare_exchange_weak(currentMax, otherMax, std::memory_order_relaxed)) {}
+	}
+
+	void Histogram::clear() {
+		for (auto& bucket : buckets) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		count.store(0, std::memory_order_relaxed);
+		max.store(0, std::memory_order_relaxed);
+	}
+
+	std::uint64_t Histogram::getPercentile(double percentile) const {
+		std::uint64_t total = getCount();
+		if (total == 0) {
+			return 0;
+		}
+		std::uint64_t target = static_cast<std::uint64_t>(percentile / 100.0 * total + 0.5);
+		if (target < 1) {
+			target = 1;
+		}
+		std::uint64_t seen = 0;
+		for (int i = 0; i < bucketCount; i++) {
+			seen += buckets[i].load(std::memory_order_relaxed);
+			if (seen >= target) {
+				std::uint64_t upperBound = bucketUpperBound(i);
+				return upperBound < getMax() ? upperBound : getMax();
+			}
+		}
+		return getMax();
+	}
+
+	ScopedTimer::~ScopedTimer() {
+		auto elapsed = std::chrono::steady_clock::now() - startTime;
+		histograms[phase].record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+	}
+
+	Histogram& getHistogram(Phase phase) {
+		return histograms[phase];
+	}
+
+	const char* getPhaseName(Phase phase) {
+		switch (phase) {
+			case inputWait: return "input wait";
+			case inputParse: return "input parse";
+			case boardUpdate: return "board update";
+			case render: return "render";
+			case engine: return "engine";
+			default: return "unknown";
+		}
+	}
+
+	void writeSummary(std::ostream& out) {
+		out << std::left << std::setw(14) << "phase (ms)" << std::right
+			<< std::setw(8) << "count" << std::setw(12) << "p50" << std::setw(12) << "p90"
+			<< std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+		for (int i = 0; i < phaseCount; i++) {
+			const Histogram& histogram = histograms[i];
+			if (histogram.getCount() == 0) {
+				continue;
+			}
+			out << std::left << std::setw(14) << getPhaseName(static_cast<Phase>(i)) << std::right
+				<< std::setw(8) << histogram.getCount();
+			writeDuration(out, histogram.getPercentile(50));
+			writeDuration(out, histogram.getPercentile(90));
+			writeDuration(out, histogram.getPercentile(99));
+			writeDuration(out, histogram.getMax());
+			out << "\n";
+		}
+	}
+
+	void dumpSummary(const std::string& filename) {
+		std::ofstream file(filename, std::ios::app);
+		if (file) {
+			writeSummary(file);
+			file << "\n";
+		}
+	}
+
+	void installSignalHandler() {
+#ifdef _WIN32
+		std::signal(SIGBREAK, requestDump);
+#else
+		std::signal(SIGUSR1, requestDump);
+#endif
+	}
+
+	void dumpIfRequested(const std::string& filename) {
+		if (dumpRequested) {
+			dumpRequested = 0;
+			dumpSummary(filename);
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace profiler {
+	enum Phase {
+		inputWait,
+		inputParse,
+		boardUpdate,
+		render,
+		engine,
+		phaseCount,
+	};
+
+	/**
+	* @brief fixed-size log-linear histogram of durations in nanoseconds, in the style of HdrHistogram
+	* Every power of two is split into 16 buckets, so any recorded value is within about 6% of its bucket,
+	* from a nanosecond up to hundreds of years, in 8 KB and with no allocation.
+	* Counts are relaxed atomics so the histogram can be read while it is being written.
+	*/
+	class Histogram {
+		public:
+			void record(std::uint64_t nanoseconds);
+			void merge(const Histogram& other);
+			void clear();
+			std::uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+			std::uint64_t getMax() const { return max.load(std::memory_order_relaxed); }
+			/**
+			* @param percentile, from 0 to 100
+			* @return the highest value that falls in the same bucket as the given percentile
+			*/
+			std::uint64_t getPercentile(double percentile) const;
+		private:
+			static const int subBucketBits = 4;
+			static const int bucketCount = (64 - subBucketBits + 1) << subBucketBits;
+			static int bucketIndex(std::uint64_t value);
+			static std::uint64_t bucketUpperBound(int index);
+			std::array<std::atomic<std::uint64_t>, bucketCount> buckets{};
+			std::atomic<std::uint64_t> count{ 0 };
+			std::atomic<std::uint64_t> max{ 0 };
+	};
+
+	/**
+	* @brief records how long it lives into the histogram of a phase
+	*/
+	class ScopedTimer {
+		public:
+			explicit ScopedTimer(Phase phase) : phase(phase), startTime(std::chrono::steady_clock::now()) {}
+			~ScopedTimer();
+			ScopedTimer(const ScopedTimer&) = delete;
+			ScopedTimer& operator=(const ScopedTimer&) = delete;
+		private:
+			Phase phase;
+			std::chrono::steady_clock::time_point startTime;
+	};
+
+	Histogram& getHistogram(Phase phase);
+	const char* getPhaseName(Phase phase);
+	/**
+	* @brief writes count, p50, p90, p99 and max of every phase that recorded anything
+	*/
+	void writeSummary(std::ostream& out);
+	/**
+	* @brief appends the summary to the given file
+	*/
+	void dumpSummary(const std::string& filename);
+	/**
+	* @brief makes SIGUSR1 (SIGBREAK on Windows) request a dump, which happens at the next dumpIfRequested()
+	*/
+	void installSignalHandler();
+	void dumpIfRequested(const std::string& filename);
+}
+
+#endif
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include "proof_search.hpp"
+
+namespace {
+	const std::uint32_t infinity = 0x3FFFFFFF;
+	const std::uint64_t xToMoveKey = 0x9E3779B97F4A7C15ULL;
+	const std::uint64_t xAttacksKey = 0xC2B2AE3D27D4EB4FULL;
+
+	std::uint32_t saturatingAdd(std::uint32_t a, std::uint32_t b) {
+		return (a >= infinity || b >= infinity || a + b >= infinity) ? infinity : a + b;
+	}
+
+	char opponentOf(char symbol) {
+		return symbol == 'X' ? 'O' : 'X';
+	}
+}
+
+ProofNumberSearch::ProofNumberSearch(std::size_t tableEntries) {
+	std::size_t size = 1;
+	while (size * 2 <= tableEntries) {
+		size *= 2;
+	}
+	table.resize(size);
+	counted.resize(size);
+}
+
+std::uint64_t ProofNumberSearch::nodeKey(const Board& board, char toMove) const {
+	// proof numbers depend on which side is trying to win, so the two runs never share entries
+	return board.hash() ^ (toMove == 'X' ? xToMoveKey : 0) ^ (attacker == 'X' ? xAttacksKey : 0);
+}
+
+void ProofNumberSearch::store(std::uint64_t key, std::uint32_t proof, std::uint32_t disproof) {
+	table[key & (table.size() - 1)] = { key, proof, disproof };
+}
+
+void ProofNumberSearch::lookup(Child& child) const {
+	if (child.isTerminal) {
+		return;
+	}
+	const Entry& entry = table[child.key & (table.size() - 1)];
+	if (entry.key == child.key) {
+		child.proof = entry.proof;
+		child.disproof = entry.disproof;
+	}
+	else {
+		child.proof = 1;
+		child.disproof = 1;
+	}
+}
+
+ProofNumberSearch::Status ProofNumberSearch::statusOf(std::uint64_t key) const {
+	const Entry& entry = table[key & (table.size() - 1)];
+	if (entry.key != key) {
+		return open;
+	}
+	return entry.proof == 0 ? proven : entry.disproof == 0 ? disproven : open;
+}
+
+void ProofNumberSearch::generateChildren(Board& board, char toMove, std::vector<Child>& children) const {
+	children.clear();
+	for (int row = 0; row < board.getSize(); row++) {
+		for (int col = 0; col < board.getSize(); col++) {
+			if (board.getCell(row, col) != ' ') {
+				continue;
+			}
+			board.setCell(row, col, toMove);
+			Child child{ row, col, nodeKey(board, opponentOf(toMove)), false, 1, 1 };
+			if (board.isWinningMove(row, col)) {
+				child.isTerminal = true;
+				child.proof = toMove == attacker ? 0 : infinity;
+				child.disproof = toMove == attacker ? infinity : 0;
+			}
+			else if (!board.isMovesLeft()) {
+				// a draw is not a win for the attacker
+				child.isTerminal = true;
+				child.proof = infinity;
+				child.disproof = 0;
+			}
+			board.setCell(row, col, ' ');
+			children.push_back(child);
+		}
+	}
+}
+
+void ProofNumberSearch::search(Board& board, char toMove, std::uint64_t key, std::uint32_t proofThreshold, std::uint32_t disproofThreshold) {
+	nodes++;
+	const bool isOrNode = toMove == attacker;
+	std::vector<Child> children;
+	generateChildren(board, toMove, children);
+
+	while (true) {
+		std::uint32_t proof = isOrNode ? infinity : 0;
+		std::uint32_t disproof = isOrNode ? 0 : infinity;
+		std::size_t best = 0;
+		std::uint32_t bestValue = infinity;
+		std::uint32_t secondValue = infinity;
+
+		for (std::size_t i = 0; i < children.size(); i++) {
+			Child& child = children[i];
+			lookup(child);
+			// an OR node is settled by its easiest child to prove, an AND node by its easiest child to disprove
+			std::uint32_t value = isOrNode ? child.proof : child.disproof;
+			if (isOrNode) {
+				proof = std::min(proof, child.proof);
+				disproof = saturatingAdd(disproof, child.disproof);
+			}
+			else {
+				proof = saturatingAdd(proof, child.proof);
+				disproof = std::min(disproof, child.disproof);
+			}
+			if (value < bestValue) {
+				secondValue = bestValue;
+				bestValue = value;
+				best = i;
+			}
+			else if (value < secondValue) {
+				secondValue = value;
+			}
+		}
+
+		if (proof >= proofThreshold || disproof >= disproofThreshold || nodes >= maxNodes) {
+			store(key, proof, disproof);
+			return;
+		}
+
+		Child& child = children[best];
+		std::uint32_t childProofThreshold;
+		std::uint32_t childDisproofThreshold;
+		if (isOrNode) {
+			childProofThreshold = std::min(proofThreshold, saturatingAdd(secondValue, 1));
+			childDisproofThreshold = disproofThreshold >= infinity ? infinity : disproofThreshold - disproof + child.disproof;
+		}
+		else {
+			childProofThreshold = proofThreshold >= infinity ? infinity : proofThreshold - proof + child.proof;
+			childDisproofThreshold = std::min(disproofThreshold, saturatingAdd(secondValue, 1));
+		}
+
+		board.setCell(child.row, child.col, toMove);
+		search(board, opponentOf(toMove), child.key, childProofThreshold, childDisproofThreshold);
+		board.setCell(child.row, child.col, ' ');
+	}
+}
+
+ProofNumberSearch::Status ProofNumberSearch::prove(Board& board, char toMove, char attacker) {
+	this->attacker = attacker;
+	std::uint64_t key = nodeKey(board, toMove);
+	search(board, toMove, key, infinity, infinity);
+	return statusOf(key);
+}
+
+bool ProofNumberSearch::markCounted(std::uint64_t key) {
+	// the low bit is always set, so no key reads as an empty slot
+	key |= 1;
+	std::size_t mask = counted.size() - 1;
+	std::size_t slot = (key >> 1) & mask;
+	while (counted[slot] != 0) {
+		if (counted[slot] == key) {
+			return false;
+		}
+		slot = (slot + 1) & mask;
+	}
+	if (countedSize * 4 >= counted.size() * 3) {
+		countedFull = true;
+		return false;
+	}
+	counted[slot] = key;
+	countedSize++;
+	return true;
+}
+
+void ProofNumberSearch::clearCounted() {
+	std::fill(counted.begin(), counted.end(), 0);
+	countedSize = 0;
+}
+
+std::size_t ProofNumberSearch::countTree(Board& board, char toMove, bool proof, int depth) {
+	if (!markCounted(nodeKey(board, toMove))) {
+		return 0;
+	}
+	// a proof needs one winning move at OR nodes and every move at AND nodes, a disproof the other way round
+	const bool needsOneChild = (toMove == attacker) == proof;
+	const Status wanted = proof ? proven : disproven;
+	if (countChildren.size() <= static_cast<std::size_t>(depth)) {
+		countChildren.resize(depth + 1);
+	}
+	generateChildren(board, toMove, countChildren[depth]);
+
+	std::size_t size = 1;
+	for (std::size_t i = 0; i < countChildren[depth].size(); i++) {
+		// a deeper level may grow countChildren and move this level's list, so it is indexed afresh each time
+		Child child = countChildren[depth][i];
+		if (child.isTerminal) {
+			bool settles = proof ? child.proof == 0 : child.disproof == 0;
+			if (needsOneChild && !settles) {
+				continue;
+			}
+			if (markCounted(child.key)) {
+				size++;
+			}
+			if (needsOneChild) {
+				return size;
+			}
+			continue;
+		}
+
+		board.setCell(child.row, child.col, toMove);
+		Status status = statusOf(child.key);
+		if (status == open) {
+			// the entry was overwritten in the bounded table, so settle this child again
+			search(board, opponentOf(toMove), child.key, infinity, infinity);
+			status = statusOf(child.key);
+		}
+		if (status == wanted) {
+			size += countTree(board, opponentOf(toMove), proof, depth + 1);
+		}
+		board.setCell(child.row, child.col, ' ');
+		if (needsOneChild && status == wanted) {
+			return size;
+		}
+	}
+	return size;
+}
+
+std::pair<int, int> ProofNumberSearch::findSettlingMove(Board& board, char toMove, bool proof) {
+	std::vector<Child> children;
+	generateChildren(board, toMove, children);
+	// first try the table, then settle children again in case their entries were overwritten
+	for (int pass = 0; pass < 2; pass++) {
+		for (Child& child : children) {
+			if (pass == 1 && !child.isTerminal) {
+				board.setCell(child.row, child.col, toMove);
+				search(board, opponentOf(toMove), child.key, infinity, infinity);
+				board.setCell(child.row, child.col, ' ');
+			}
+			lookup(child);
+			if ((proof && child.proof == 0) || (!proof && child.disproof == 0)) {
+				return { child.row, child.col };
+			}
+		}
+	}
+	return { -1, -1 };
+}
+
+ProofResult ProofNumberSearch::solve(Board board, char symbol, std::size_t maxNodes) {
+	this->maxNodes = maxNodes;
+	nodes = 0;
+	ProofResult result{ ProofResult::unknown, { -1, -1 }, 0, 0 };
+
+	std::vector<Child> children;
+	clearCounted();
+	countedFull = false;
+
+	Status canWin = prove(board, symbol, symbol);
+	if (canWin == proven) {
+		result.outcome = ProofResult::won;
+		result.move = findSettlingMove(board, symbol, true);
+		result.proofTreeSize = countTree(board, symbol, true, 0);
+	}
+	else if (canWin == disproven) {
+		std::size_t disproofSize = countTree(board, symbol, false, 0);
+		Status canLose = prove(board, symbol, opponentOf(symbol));
+		generateChildren(board, symbol, children);
+		clearCounted();
+
+		if (canLose == proven) {
+			result.outcome = ProofResult::lost;
+			result.proofTreeSize = countTree(board, symbol, true, 0);
+			// every move loses, so make the one that is hardest to refute
+			std::uint32_t mostDisproof = 0;
+			for (Child& child : children) {
+				lookup(child);
+				if (result.move.first < 0 || child.disproof > mostDisproof) {
+					mostDisproof = child.disproof;
+					result.move = { child.row, child.col };
+				}
+			}
+		}
+		else if (canLose == disproven) {
+			result.outcome = ProofResult::drawn;
+			result.move = findSettlingMove(board, symbol, false);
+			result.proofTreeSize = disproofSize + countTree(board, symbol, false, 0);
+		}
+	}
+
+	result.nodesSearched = nodes;
+	result.proofTreeExact = !countedFull;
+	return result;
+}
@@ -0,0 +1,106 @@
+#ifndef PROOF_SEARCH_HPP
+#define PROOF_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "board.hpp"
+
+struct ProofResult {
+	enum Outcome {
+		won,
+		lost,
+		drawn,
+		unknown,
+	};
+	/**
+	* @brief the result with best play, for the side to move
+	*/
+	Outcome outcome;
+	/**
+	* @brief a move that achieves the outcome, or { -1, -1 } if none is known
+	*/
+	std::pair<int, int> move;
+	/**
+	* @brief positions in the proof (or, for a draw, the two disproofs) that certify the outcome
+	*/
+	std::size_t proofTreeSize;
+	std::size_t nodesSearched;
+	/**
+	* @brief false if the proof tree had more positions than the count could remember, proofTreeSize is then a lower bound
+	*/
+	bool proofTreeExact = true;
+};
+
+/**
+* @brief depth-first proof-number search (df-pn) for k-in-a-row on any Board
+* Instead of scoring every line like minimax, df-pn only tries to prove or disprove that one side wins,
+* always expanding the move that is cheapest to settle, which suits deep but narrow forcing lines.
+* A position is solved with two runs: can the side to move win, and if not, can the opponent.
+* Proof and disproof numbers are kept in a fixed-size table, so memory stays bounded however large the tree.
+* Counting the proof tree afterwards remembers the positions it has counted in a set with as many slots as the
+* table, so it is bounded the same way. Once that set is three quarters full the count stops growing and is
+* reported as a lower bound.
+*/
+class ProofNumberSearch {
+	public:
+		explicit ProofNumberSearch(std::size_t tableEntries = 1 << 20);
+		/**
+		* @param board, a position that is not yet won or drawn
+		* @param symbol, the side to move
+		* @param maxNodes, node budget over both runs, the outcome is unknown if it runs out
+		*/
+		ProofResult solve(Board board, char symbol, std::size_t maxNodes);
+	private:
+		enum Status {
+			proven,
+			disproven,
+			open,
+		};
+		struct Entry {
+			std::uint64_t key;
+			std::uint32_t proof;
+			std::uint32_t disproof;
+		};
+		struct Child {
+			int row;
+			int col;
+			std::uint64_t key;
+			bool isTerminal;
+			std::uint32_t proof;
+			std::uint32_t disproof;
+		};
+		Status prove(Board& board, char toMove, char attacker);
+		void search(Board& board, char toMove, std::uint64_t key, std::uint32_t proofThreshold, std::uint32_t disproofThreshold);
+		void generateChildren(Board& board, char toMove, std::vector<Child>& children) const;
+		void lookup(Child& child) const;
+		std::uint64_t nodeKey(const Board& board, char toMove) const;
+		void store(std::uint64_t key, std::uint32_t proof, std::uint32_t disproof);
+		Status statusOf(std::uint64_t key) const;
+		/**
+		* @return a move of toMove whose position is proven, or disproven if proof is false
+		*/
+		std::pair<int, int> findSettlingMove(Board& board, char toMove, bool proof);
+		/**
+		* @param depth, stones played below the root, picks the child list this level of the count reuses
+		*/
+		std::size_t countTree(Board& board, char toMove, bool proof, int depth);
+		/**
+		* @return true if key had not been counted yet and there was room to remember it
+		*/
+		bool markCounted(std::uint64_t key);
+		void clearCounted();
+		std::vector<Entry> table;
+		// keys of the positions counted so far, open addressing with 0 for an empty slot
+		std::vector<std::uint64_t> counted;
+		std::size_t countedSize = 0;
+		bool countedFull = false;
+		// the child list of every level of countTree(), kept so the count allocates nothing per position
+		std::vector<std::vector<Child>> countChildren;
+		char attacker = 'X';
+		std::size_t nodes = 0;
+		std::size_t maxNodes = 0;
+};
+
+#endif
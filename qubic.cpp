@@ -0,0 +1,399 @@
+#include <bit>
+#include <iostream>
+#include <limits>
+#include <string>
+#include "qubic.hpp"
+#include "renderer.hpp"
+
+namespace {
+	struct LineTables {
+		std::array<std::uint64_t, QubicBoard::lineCount> lines{};
+		std::array<std::array<std::int8_t, 8>, QubicBoard::cellCount> cellLines{};
+		int count = 0;
+	};
+
+	// a line runs 4 cells in one of the 13 directions whose first non-zero step is positive, so each is found once
+	constexpr LineTables buildLineTables() {
+		LineTables tables;
+		int linesPerCell[QubicBoard::cellCount] = {};
+		for (auto& cellLines : tables.cellLines) {
+			cellLines.fill(-1);
+		}
+		for (int dl = -1; dl <= 1; dl++) {
+			for (int dr = -1; dr <= 1; dr++) {
+				for (int dc = -1; dc <= 1; dc++) {
+					int firstStep = dl != 0 ? dl : dr != 0 ? dr : dc;
+					if (firstStep <= 0) {
+						continue;
+					}
+					for (int cell = 0; cell < QubicBoard::cellCount; cell++) {
+						int layer = cell / 16, row = cell / 4 % 4, col = cell % 4;
+						int lastLayer = layer + 3 * dl, lastRow = row + 3 * dr, lastCol = col + 3 * dc;
+						if (lastLayer < 0 || lastLayer > 3 || lastRow < 0 || lastRow > 3 || lastCol < 0 || lastCol > 3) {
+							continue;
+						}
+						std::uint64_t mask = 0;
+						for (int i = 0; i < 4; i++) {
+							int lineCell = QubicBoard::cellIndex(layer + i * dl, row + i * dr, col + i * dc);
+							mask |= std::uint64_t(1) << lineCell;
+							tables.cellLines[lineCell][linesPerCell[lineCell]++] = static_cast<std::int8_t>(tables.count);
+						}
+						tables.lines[tables.count++] = mask;
+					}
+				}
+			}
+		}
+		return tables;
+	}
+
+	constexpr LineTables lineTables = buildLineTables();
+	static_assert(lineTables.count == QubicBoard::lineCount, "a 4x4x4 cube has 76 lines");
+
+	const int winScore = 1000000;
+	// scores this close to winScore are wins or losses found by the search, stored relative to the node
+	const int winThreshold = winScore - 100;
+	const int tableBits = 18;
+	const std::int8_t exactBound = 0, lowerBound = 1, upperBound = 2;
+
+	// value of a line holding 0-4 stones of one side and none of the other
+	const int lineWeights[5] = { 0, 1, 6, 40, 0 };
+
+	// empty cells completing a line that holds three of stones and none of others
+	std::uint64_t threatsOf(std::uint64_t stones, std::uint64_t others) {
+		std::uint64_t threats = 0;
+		for (std::uint64_t line : lineTables.lines) {
+			if ((line & others) == 0 && std::popcount(line & stones) == 3) {
+				threats |= line & ~stones;
+			}
+		}
+		return threats;
+	}
+
+	int lowestCell(std::uint64_t cells) {
+		return std::countr_zero(cells);
+	}
+
+	std::string cellName(int cell) {
+		return std::to_string(cell / 16 + 1) + std::to_string(cell / 4 % 4 + 1) + std::to_string(cell % 4 + 1);
+	}
+}
+
+char QubicBoard::getCell(int cell) const {
+	std::uint64_t bit = std::uint64_t(1) << cell;
+	return (x & bit) ? 'X' : (o & bit) ? 'O' : ' ';
+}
+
+bool QubicBoard::play(int cell, char symbol) {
+	if (cell < 0 || cell >= cellCount || getCell(cell) != ' ') {
+		return false;
+	}
+	(symbol == 'X' ? x : o) |= std::uint64_t(1) << cell;
+	return true;
+}
+
+void QubicBoard::undo(int cell) {
+	std::uint64_t bit = std::uint64_t(1) << cell;
+	x &= ~bit;
+	o &= ~bit;
+}
+
+bool QubicBoard::isWinningMove(int cell, char symbol) const {
+	std::uint64_t stones = getStones(symbol);
+	for (std::int8_t line : lineTables.cellLines[cell]) {
+		if (line < 0) {
+			break;
+		}
+		if ((stones & lineTables.lines[line]) == lineTables.lines[line]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool QubicBoard::hasWon(char symbol) const {
+	std::uint64_t stones = getStones(symbol);
+	for (std::uint64_t line : lineTables.lines) {
+		if ((stones & line) == line) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::uint64_t QubicBoard::getThreats(char symbol) const {
+	return threatsOf(getStones(symbol), getStones(symbol == 'X' ? 'O' : 'X'));
+}
+
+const std::array<std::uint64_t, QubicBoard::lineCount>& QubicBoard::getLines() {
+	return lineTables.lines;
+}
+
+const std::array<std::int8_t, 8>& QubicBoard::getCellLines(int cell) {
+	return lineTables.cellLines[cell];
+}
+
+QubicEngine::QubicEngine(int moveTime) : moveTime(moveTime), table(std::size_t(1) << tableBits) {}
+
+std::uint64_t QubicEngine::hashOf(std::uint64_t mine, std::uint64_t theirs) {
+	std::uint64_t hash = mine * 0x9E3779B97F4A7C15ULL ^ (theirs + 0x632BE59BD9B4E019ULL) * 0xBF58476D1CE4E5B9ULL;
+	return hash ^ (hash >> 29);
+}
+
+int QubicEngine::evaluate(std::uint64_t mine, std::uint64_t theirs) {
+	int score = 0;
+	for (std::uint64_t line : lineTables.lines) {
+		int myStones = std::popcount(line & mine);
+		int theirStones = std::popcount(line & theirs);
+		if (theirStones == 0) {
+			score += lineWeights[myStones];
+		}
+		else if (myStones == 0) {
+			score -= lineWeights[theirStones];
+		}
+	}
+	return score;
+}
+
+int QubicEngine::orderMoves(std::uint64_t mine, std::uint64_t theirs, std::uint64_t candidates, int firstCell, int* moves) const {
+	int priorities[QubicBoard::cellCount];
+	int count = 0;
+	for (; candidates; candidates &= candidates - 1) {
+		int cell = lowestCell(candidates);
+		int priority = 0;
+		if (cell == firstCell) {
+			priority = std::numeric_limits<int>::max();
+		}
+		else {
+			// building towards a threat of our own first, then blocking the lines the opponent is building
+			for (std::int8_t line : lineTables.cellLines[cell]) {
+				if (line < 0) {
+					break;
+				}
+				int myStones = std::popcount(lineTables.lines[line] & mine);
+				int theirStones = std::popcount(lineTables.lines[line] & theirs);
+				if (theirStones == 0) {
+					priority += myStones == 2 ? 50 : myStones == 1 ? 8 : 1;
+				}
+				if (myStones == 0) {
+					priority += theirStones == 2 ? 30 : theirStones == 1 ? 4 : 0;
+				}
+			}
+		}
+		int i = count++;
+		for (; i > 0 && priorities[i - 1] < priority; i--) {
+			priorities[i] = priorities[i - 1];
+			moves[i] = moves[i - 1];
+		}
+		priorities[i] = priority;
+		moves[i] = cell;
+	}
+	return count;
+}
+
+int QubicEngine::negamax(std::uint64_t mine, std::uint64_t theirs, int depth, int alpha, int beta, int ply) {
+	nodes++;
+	if ((nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) {
+		timedOut = true;
+	}
+	if (timedOut) {
+		return 0;
+	}
+
+	std::uint64_t empty = ~(mine | theirs);
+	if (empty == 0) {
+		return 0;
+	}
+	// a line one stone short is won on this move, and two of the opponent's cannot both be blocked
+	if (threatsOf(mine, theirs)) {
+		return winScore - (ply + 1);
+	}
+	std::uint64_t theirThreats = threatsOf(theirs, mine);
+	if (std::popcount(theirThreats) >= 2) {
+		return -(winScore - (ply + 2));
+	}
+	if (!theirThreats && depth <= 0) {
+		return evaluate(mine, theirs);
+	}
+
+	std::uint64_t key = hashOf(mine, theirs);
+	Entry& entry = table[key & ((std::size_t(1) << tableBits) - 1)];
+	int tableMove = -1;
+	if (entry.key == key) {
+		tableMove = entry.bestCell;
+		if (entry.depth >= depth) {
+			int score = entry.score > winThreshold ? entry.score - ply : entry.score < -winThreshold ? entry.score + ply : entry.score;
+			if (entry.bound == exactBound || (entry.bound == lowerBound && score >= beta) || (entry.bound == upperBound && score <= alpha)) {
+				return score;
+			}
+		}
+	}
+
+	// a forced block does not use up depth, so threat sequences are read to the end
+	std::uint64_t candidates = theirThreats ? theirThreats : empty;
+	int nextDepth = theirThreats ? depth : depth - 1;
+	int moves[QubicBoard::cellCount];
+	int moveCount = orderMoves(mine, theirs, candidates, tableMove, moves);
+
+	int originalAlpha = alpha;
+	int bestScore = -winScore;
+	int bestCell = moves[0];
+	for (int i = 0; i < moveCount; i++) {
+		int score = -negamax(theirs, mine | (std::uint64_t(1) << moves[i]), nextDepth, -beta, -alpha, ply + 1);
+		if (timedOut) {
+			return 0;
+		}
+		if (score > bestScore) {
+			bestScore = score;
+			bestCell = moves[i];
+		}
+		if (score > alpha) {
+			alpha = score;
+		}
+		if (alpha >= beta) {
+			break;
+		}
+	}
+
+	entry.key = key;
+	entry.score = bestScore > winThreshold ? bestScore + ply : bestScore < -winThreshold ? bestScore - ply : bestScore;
+	entry.depth = static_cast<std::int8_t>(depth < 0 ? 0 : depth);
+	entry.bound = bestScore <= originalAlpha ? upperBound : bestScore >= beta ? lowerBound : exactBound;
+	entry.bestCell = static_cast<std::int8_t>(bestCell);
+	return bestScore;
+}
+
+int QubicEngine::findBestMove(const QubicBoard& board, char symbol) {
+	std::uint64_t mine = board.getStones(symbol);
+	std::uint64_t theirs = board.getStones(symbol == 'X' ? 'O' : 'X');
+	std::uint64_t empty = board.getEmpty();
+	lastDepth = 0;
+	if (empty == 0) {
+		return -1;
+	}
+
+	std::uint64_t myThreats = threatsOf(mine, theirs);
+	if (myThreats) {
+		return lowestCell(myThreats);
+	}
+	std::uint64_t theirThreats = threatsOf(theirs, mine);
+	std::uint64_t candidates = theirThreats ? theirThreats : empty;
+	if (std::popcount(candidates) == 1) {
+		return lowestCell(candidates);
+	}
+
+	deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(moveTime);
+	timedOut = false;
+	int moves[QubicBoard::cellCount];
+	int moveCount = orderMoves(mine, theirs, candidates, -1, moves);
+	int bestCell = moves[0];
+
+	for (int depth = 1; depth <= std::popcount(empty); depth++) {
+		moveCount = orderMoves(mine, theirs, candidates, bestCell, moves);
+		int alpha = -winScore - 1;
+		int iterationBest = moves[0];
+		for (int i = 0; i < moveCount; i++) {
+			int score = -negamax(theirs, mine | (std::uint64_t(1) << moves[i]), depth - 1, -winScore - 1, -alpha, 1);
+			if (timedOut) {
+				break;
+			}
+			if (score > alpha) {
+				alpha = score;
+				iterationBest = moves[i];
+			}
+		}
+		// an unfinished depth is thrown away, its best move so far may not have been compared with the rest
+		if (timedOut) {
+			break;
+		}
+		bestCell = iterationBest;
+		lastDepth = depth;
+		if (alpha > winThreshold || alpha < -winThreshold) {
+			break;
+		}
+	}
+	return bestCell;
+}
+
+void playQubic(Renderer& renderer, bool computerStarts) {
+	QubicBoard board;
+	QubicEngine engine;
+	char symbol = computerStarts ? 'O' : 'X';
+	std::string statusMessage = "Get four in a row in any direction, across layers too.";
+	std::string errorMessage;
+	char winner = ' ';
+
+	while (winner == ' ') {
+		if (symbol == 'O') {
+			auto startTime = std::chrono::steady_clock::now();
+			int cell = engine.findBestMove(board, 'O');
+			long elapsed = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+			board.play(cell, 'O');
+			statusMessage = "Computer played " + cellName(cell) + " (depth " + std::to_string(engine.getLastDepth())
+				+ ", " + std::to_string(elapsed) + " ms)";
+			winner = board.isWinningMove(cell, 'O') ? 'O' : board.isFull() ? 'T' : ' ';
+			symbol = 'X';
+			continue;
+		}
+
+		std::string promptMessage = "Your move (X), enter layer, row and column (e.g. 213): ";
+		renderer.clearScreen();
+		renderer.renderQubicScreen(board, statusMessage, promptMessage + "\n" + errorMessage);
+		std::string input = renderer.prompt(static_cast<int>(promptMessage.length()));
+		if (!std::cin) {
+			return;
+		}
+
+		bool valid = input.size() == 3;
+		for (char digit : input) {
+			valid = valid && digit >= '1' && digit <= '4';
+		}
+		int cell = valid ? QubicBoard::cellIndex(input[0] - '1', input[1] - '1', input[2] - '1') : -1;
+		if (!valid || !board.play(cell, 'X')) {
+			errorMessage = valid ? "That cell is already taken." : "Enter three digits from 1 to 4.";
+			continue;
+		}
+		errorMessage = "";
+		winner = board.isWinningMove(cell, 'X') ? 'X' : board.isFull() ? 'T' : ' ';
+		symbol = 'O';
+	}
+
+	renderer.clearScreen();
+	renderer.renderQubicScreen(board, statusMessage, winner == 'T' ? "It's a tie!" : std::string("Player ") + winner + " wins!");
+}
+
+void runQubicSelfPlay(int games) {
+	for (int game = 0; game < games; game++) {
+		QubicBoard board;
+		QubicEngine engines[2] = { QubicEngine(), QubicEngine() };
+		char symbol = 'X';
+		char winner = 'T';
+		long slowestMove = 0;
+		int moves = 0;
+		int depthTotal = 0;
+
+		// the first stone goes somewhere different in every game so the games are not all the same
+		board.play(game * 37 % QubicBoard::cellCount, 'X');
+		symbol = 'O';
+
+		while (!board.isFull()) {
+			QubicEngine& engine = engines[symbol == 'X' ? 0 : 1];
+			auto startTime = std::chrono::steady_clock::now();
+			int cell = engine.findBestMove(board, symbol);
+			long elapsed = static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+			slowestMove = elapsed > slowestMove ? elapsed : slowestMove;
+			depthTotal += engine.getLastDepth();
+			moves++;
+
+			board.play(cell, symbol);
+			if (board.isWinningMove(cell, symbol)) {
+				winner = symbol;
+				break;
+			}
+			symbol = (symbol == 'X') ? 'O' : 'X';
+		}
+
+		std::cout << "game " << game + 1 << ": " << (winner == 'T' ? std::string("tie") : std::string(1, winner) + " wins")
+			<< " after " << moves + 1 << " moves, average depth " << (moves > 0 ? depthTotal / moves : 0)
+			<< ", slowest move " << slowestMove / 1000 << " ms" << std::endl;
+	}
+}
@@ -0,0 +1,104 @@
+#ifndef QUBIC_HPP
+#define QUBIC_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+* @brief a 4x4x4 Qubic board held as two 64 bit masks, one bit per cell
+* Cell index is layer * 16 + row * 4 + col. The 76 winning lines are masks built at compile time, and every cell
+* knows the 4 or 7 lines through it, so checking a move only ANDs the lines it can complete.
+*/
+class QubicBoard {
+	public:
+		static const int size = 4;
+		static const int cellCount = 64;
+		static const int lineCount = 76;
+		static constexpr int cellIndex(int layer, int row, int col) { return layer * 16 + row * 4 + col; }
+		/**
+		* @return 'X', 'O' or ' '
+		*/
+		char getCell(int cell) const;
+		/**
+		* @return false if the cell is out of range or taken
+		*/
+		bool play(int cell, char symbol);
+		void undo(int cell);
+		std::uint64_t getStones(char symbol) const { return symbol == 'X' ? x : o; }
+		std::uint64_t getEmpty() const { return ~(x | o); }
+		bool isFull() const { return (x | o) == ~std::uint64_t(0); }
+		/**
+		* @brief checks only the lines through cell
+		*/
+		bool isWinningMove(int cell, char symbol) const;
+		bool hasWon(char symbol) const;
+		/**
+		* @return the empty cells that would complete a line for symbol
+		*/
+		std::uint64_t getThreats(char symbol) const;
+		static const std::array<std::uint64_t, lineCount>& getLines();
+		/**
+		* @return the indices into getLines() of the lines through cell, ended by -1
+		*/
+		static const std::array<std::int8_t, 8>& getCellLines(int cell);
+	private:
+		std::uint64_t x = 0;
+		std::uint64_t o = 0;
+};
+
+/**
+* @brief time-bounded alpha-beta search for Qubic
+* Iterative deepening negamax over the two masks with a transposition table. A side with a line one stone
+* from complete either plays it or, if the opponent has one, blocks it without using up depth, and two open
+* threats against the side to move are a loss. Leaves are scored from the lines only one side occupies.
+*/
+class QubicEngine {
+	public:
+		/**
+		* @param moveTime, milliseconds to think per move, the search finishes the depth it is on when time runs out
+		*/
+		explicit QubicEngine(int moveTime = 150);
+		/**
+		* @return the cell to play, or -1 if the board is full
+		*/
+		int findBestMove(const QubicBoard& board, char symbol);
+		std::uint64_t getNodeCount() const { return nodes; }
+		/**
+		* @return the deepest search the last move finished
+		*/
+		int getLastDepth() const { return lastDepth; }
+	private:
+		struct Entry {
+			std::uint64_t key;
+			std::int32_t score;
+			std::int8_t depth;
+			std::int8_t bound;
+			std::int8_t bestCell;
+		};
+		int negamax(std::uint64_t mine, std::uint64_t theirs, int depth, int alpha, int beta, int ply);
+		int orderMoves(std::uint64_t mine, std::uint64_t theirs, std::uint64_t candidates, int firstCell, int* moves) const;
+		static int evaluate(std::uint64_t mine, std::uint64_t theirs);
+		static std::uint64_t hashOf(std::uint64_t mine, std::uint64_t theirs);
+		int moveTime;
+		std::chrono::steady_clock::time_point deadline;
+		bool timedOut = false;
+		std::uint64_t nodes = 0;
+		int lastDepth = 0;
+		std::vector<Entry> table;
+};
+
+class Renderer;
+
+/**
+* @brief plays Qubic in the terminal, the human is X, moves are typed as layer, row and column, e.g. 213
+*/
+void playQubic(Renderer& renderer, bool computerStarts);
+/**
+* @brief plays the engine against itself and reports the slowest move, to check it stays inside its time budget
+*/
+void runQubicSelfPlay(int games);
+
+#endif
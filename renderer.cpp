@@ -1,7 +1,11 @@
 #include "renderer.hpp"
+#include "tracer.hpp"
+#include <algorithm>
 #include <iostream>
 
-Renderer::Renderer() : screenWidth(120), screenHeight(30) {}
+Renderer::Renderer() : screenWidth(120), screenHeight(30) {
+	rowBuffer.reserve(128);
+}
 
 void Renderer::clearScreen() const {
 	std::cout << "\033[H\033[J";
@@ -22,39 +26,39 @@ void Renderer::setCursorPosition(int x, int y) const {
 	std::cout << "\033[H\033[" << x << "C\033[" << y << "B";
 }
 
-void Renderer::renderPlayingScreen(Board& board, std::string errorMessage, std::string promptMessage) {
+void Renderer::renderPlayingScreen(const Board& board, std::string_view errorMessage, std::string_view promptMessage) {
+	tracer::Span span("frame", "render");
 	const int TOTAL_LINES = 10;
 	clearScreen();
 	//horizontalLine(screenWidth);
 	setCursorHeight(TOTAL_LINES);
-	std::string title = "Tic Tac Toe";
-	renderText(title, 11);
+	renderText("Tic Tac Toe", 11);
 	newLine();
 	newLine();
 
-	const std::string grey = "\033[38;2;80;80;80m";
-	const std::string reset = "\033[0m";
+	const std::string_view grey = "\033[38;2;80;80;80m";
+	const std::string_view reset = "\033[0m";
 
-	std::string rowText = "";
+	std::string& rowText = rowBuffer;
+	rowText.clear();
 
 	for (int row = 0; row < 3; row++) {
 		for (int col = 0; col < 3; col++) {
+			rowText += ' ';
 			if (board.getCell(row, col) == ' ') {
-				rowText += " " + grey + std::to_string(row * 3 + col + 1) + reset;
-				if (col < 2) {
-					rowText += " |";
-				}
+				rowText += grey;
+				rowText += static_cast<char>('1' + row * 3 + col);
+				rowText += reset;
 			}
 			else {
-				rowText += " ";
 				rowText += board.getCell(row, col);
-				if (col < 2) {
-					rowText += " |";
-				}
+			}
+			if (col < 2) {
+				rowText += " |";
 			}
 		}
 		renderText(rowText, 10);
-		rowText = "";
+		rowText.clear();
 		if (row < 2) {
 			renderText("---+---+---", 10);
 		}
@@ -73,6 +77,7 @@ void Renderer::renderPlayingScreen(Board& board, std::string errorMessage, std::
 }
 
 void Renderer::renderGameOverScreen(Board& board, char winner) {
+	tracer::Span span("game over frame", "render");
 	const int TOTAL_LINES = 10;
 	clearScreen();
 	setCursorHeight(TOTAL_LINES);
@@ -117,6 +122,149 @@ void Renderer::renderGameOverScreen(Board& board, char winner) {
 	//renderText("Press Enter to return to menu.");
 }
 
+void Renderer::renderSpectatorScreen(const std::vector<Board>& boards, const std::string& statusMessage) {
+	tracer::Span span("spectator frame", "render");
+	const int BOARDS_PER_ROW = 6;
+	const int BOARD_WIDTH = 11;
+	const std::string gap = "    ";
+	int boardRows = (static_cast<int>(boards.size()) + BOARDS_PER_ROW - 1) / BOARDS_PER_ROW;
+	int totalLines = 3 + boardRows * 6;
+	setCursorHeight(std::min(totalLines, screenHeight / 2));
+
+	renderText("Spectating");
+	newLine();
+
+	for (int first = 0; first < static_cast<int>(boards.size()); first += BOARDS_PER_ROW) {
+		int count = std::min(BOARDS_PER_ROW, static_cast<int>(boards.size()) - first);
+		int rowWidth = count * BOARD_WIDTH + (count - 1) * static_cast<int>(gap.length());
+
+		std::string rowText = "";
+		for (int row = 0; row < 3; row++) {
+			for (int i = first; i < first + count; i++) {
+				for (int col = 0; col < 3; col++) {
+					rowText += " ";
+					rowText += boards[i].getCell(row, col);
+					rowText += (col < 2) ? " |" : " ";
+				}
+				if (i < first + count - 1) {
+					rowText += gap;
+				}
+			}
+			renderText(rowText, rowWidth);
+			rowText = "";
+			if (row < 2) {
+				for (int i = first; i < first + count; i++) {
+					rowText += "---+---+---";
+					if (i < first + count - 1) {
+						rowText += gap;
+					}
+				}
+				renderText(rowText, rowWidth);
+				rowText = "";
+			}
+		}
+		newLine();
+	}
+
+	renderText(statusMessage);
+}
+
+void Renderer::renderQubicScreen(const QubicBoard& board, const std::string& statusMessage, const std::string& promptMessage) {
+	tracer::Span span("qubic frame", "render");
+	const int TOTAL_LINES = 12;
+	const int LAYER_WIDTH = 10;
+	const std::string gap = "      ";
+	const int rowWidth = QubicBoard::size * LAYER_WIDTH + (QubicBoard::size - 1) * static_cast<int>(gap.length());
+	const std::string grey = "\033[38;2;80;80;80m";
+	const std::string reset = "\033[0m";
+	setCursorHeight(TOTAL_LINES);
+
+	renderText("Qubic");
+	newLine();
+
+	std::string rowText = "";
+	for (int layer = 0; layer < QubicBoard::size; layer++) {
+		rowText += " Layer " + std::to_string(layer + 1) + "  ";
+		if (layer < QubicBoard::size - 1) {
+			rowText += gap;
+		}
+	}
+	renderText(rowText, rowWidth);
+	rowText = "";
+	for (int layer = 0; layer < QubicBoard::size; layer++) {
+		rowText += "   1 2 3 4";
+		if (layer < QubicBoard::size - 1) {
+			rowText += gap;
+		}
+	}
+	renderText(grey + rowText + reset, rowWidth);
+	rowText = "";
+
+	for (int row = 0; row < QubicBoard::size; row++) {
+		for (int layer = 0; layer < QubicBoard::size; layer++) {
+			rowText += grey + std::to_string(row + 1) + reset + " ";
+			for (int col = 0; col < QubicBoard::size; col++) {
+				char cell = board.getCell(QubicBoard::cellIndex(layer, row, col));
+				rowText += " ";
+				rowText += cell == ' ' ? grey + "." + reset : std::string(1, cell);
+			}
+			if (layer < QubicBoard::size - 1) {
+				rowText += gap;
+			}
+		}
+		renderText(rowText, rowWidth);
+		rowText = "";
+	}
+
+	newLine();
+	renderText(statusMessage);
+	newLine();
+	renderText(promptMessage);
+}
+
+void Renderer::renderUnboundedScreen(const SparseBoard& board, const std::string& statusMessage, const std::string& promptMessage) {
+	tracer::Span span("unbounded frame", "render");
+	const int VIEW_SIZE = 15;
+	const int CELL_WIDTH = 3;
+	const int TOTAL_LINES = VIEW_SIZE + 8;
+	const int rowWidth = (VIEW_SIZE + 1) * CELL_WIDTH;
+	const std::string grey = "\033[38;2;80;80;80m";
+	const std::string reset = "\033[0m";
+	setCursorHeight(TOTAL_LINES);
+
+	int minRow, maxRow, minCol, maxCol;
+	board.getBounds(minRow, maxRow, minCol, maxCol);
+	int top = (minRow + maxRow) / 2 - VIEW_SIZE / 2;
+	int left = (minCol + maxCol) / 2 - VIEW_SIZE / 2;
+	auto label = [&](int number) {
+		std::string text = std::to_string(number);
+		return std::string(text.length() < CELL_WIDTH ? CELL_WIDTH - text.length() : 0, ' ') + text;
+	};
+
+	renderText(std::to_string(board.getWinLength()) + " in a row, unbounded");
+	newLine();
+
+	std::string rowText = std::string(CELL_WIDTH, ' ');
+	for (int col = left; col < left + VIEW_SIZE; col++) {
+		rowText += label(col);
+	}
+	renderText(grey + rowText + reset, rowWidth);
+
+	for (int row = top; row < top + VIEW_SIZE; row++) {
+		rowText = grey + label(row) + reset;
+		for (int col = left; col < left + VIEW_SIZE; col++) {
+			char cell = board.getCell(row, col);
+			rowText += std::string(CELL_WIDTH - 1, ' ') + (cell == ' ' ? grey + "." + reset : std::string(1, cell));
+		}
+		renderText(rowText, rowWidth);
+	}
+
+	newLine();
+	renderText(statusMessage);
+	newLine();
+	renderText(promptMessage);
+}
+
 void Renderer::newLine() const {
 	std::cout << "\n";
 }
@@ -174,7 +322,7 @@ void Renderer::borderedText(std::string text, int paddingY, int paddingX, char b
 	}
 }
 
-void Renderer::renderText(const std::string &text, const int length, bool newLine) const {
+void Renderer::renderText(std::string_view text, const int length, bool newLine) const {
 	std::cout
 		<< "\033[" << (screenWidth / 2 - (length == -1 ? text.length() : length)/ 2) << "C"
 		<< text;
@@ -1,18 +1,35 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
+#include <string>
+#include <string_view>
+#include <vector>
 #include "board.hpp"
+#include "qubic.hpp"
+#include "unbounded.hpp"
 
 class Renderer {
 	public:
 		Renderer();
-		void renderText(const std::string &text, int length = -1, bool newLine = true) const;
+		void renderText(std::string_view text, int length = -1, bool newLine = true) const;
 		void renderTextLeft(const std::string& text, int marginLeft = 0, bool newLine = true) const;
 		void newLine() const;
 		void clearScreen() const;
 		void renderStartingScreen();
-		void renderPlayingScreen(Board& board, std::string errorMessage, std::string promptMessage);
+		/**
+		* @brief draws the board, the prompt and any error, allocating nothing once the first frame has been drawn
+		*/
+		void renderPlayingScreen(const Board& board, std::string_view errorMessage, std::string_view promptMessage);
 		void renderGameOverScreen(Board& board, char winner);
+		void renderSpectatorScreen(const std::vector<Board>& boards, const std::string& statusMessage);
+		/**
+		* @brief draws the four Qubic layers side by side, layer 1 on the left
+		*/
+		void renderQubicScreen(const QubicBoard& board, const std::string& statusMessage, const std::string& promptMessage);
+		/**
+		* @brief draws the 15x15 cells around the middle of the stones, labelled with their row and column
+		*/
+		void renderUnboundedScreen(const SparseBoard& board, const std::string& statusMessage, const std::string& promptMessage);
 		void labelScreenColumns();
 		void labelScreenRows();
 		std::string prompt(int promptMessageLength) const;
@@ -24,6 +41,8 @@ class Renderer {
 		void horizontalLine(int length) const;
 		void setCursorHeight(int totalContentLines) const;
 		void setCursorPosition(int x, int y) const;
+		// reused for each row of the playing screen, so drawing a frame does not allocate
+		std::string rowBuffer;
 };
 
 #endif
@@ -0,0 +1,162 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+#include "keyboard.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+
+namespace replay {
+	namespace {
+		const char* const fileHeader = "tttkeys 1";
+
+		struct RecordedKey {
+			std::int64_t microseconds;
+			int key;
+		};
+
+		// discards everything written to it and counts the bytes
+		class CountingBuffer : public std::streambuf {
+			public:
+				std::uint64_t getCount() const { return count; }
+			protected:
+				int_type overflow(int_type c) override {
+					if (!traits_type::eq_int_type(c, traits_type::eof())) {
+						count++;
+					}
+					return traits_type::not_eof(c);
+				}
+				std::streamsize xsputn(const char*, std::streamsize n) override {
+					count += static_cast<std::uint64_t>(n);
+					return n;
+				}
+			private:
+				std::uint64_t count = 0;
+		};
+
+		std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+		std::mutex mutex;
+
+		std::ofstream recording;
+		bool recordingStarted = false;
+
+		bool replaying = false;
+		bool paced = false;
+		std::vector<RecordedKey> keys;
+		std::size_t nextIndex = 0;
+		CountingBuffer sink;
+		std::streambuf* terminal = nullptr;
+		// the latency of a turn runs from handing out a key to the next time the game waits for one, unless the
+		// game rejected the key
+		profiler::Histogram turnLatency;
+		bool turnRunning = false;
+		std::chrono::steady_clock::time_point turnStart;
+
+		std::int64_t elapsedMicroseconds() {
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+		}
+
+		void writeReport() {
+			double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+			std::cout.rdbuf(terminal);
+			std::cout << "replayed " << nextIndex << " of " << keys.size() << " keys in " << std::fixed << std::setprecision(1)
+				<< elapsed * 1000 << " ms" << (paced ? " at the recorded pace" : "") << std::endl;
+			std::cout << turnLatency.getCount() << " turns, latency (us): p50 " << turnLatency.getPercentile(50) / 1000.0
+				<< "  p90 " << turnLatency.getPercentile(90) / 1000.0
+				<< "  p99 " << turnLatency.getPercentile(99) / 1000.0
+				<< "  max " << turnLatency.getMax() / 1000.0 << std::endl;
+			std::cout << sink.getCount() << " bytes written to the terminal" << std::endl;
+		}
+	}
+
+	bool startRecording(const std::string& filename) {
+		std::lock_guard<std::mutex> lock(mutex);
+		recording.open(filename);
+		if (!recording) {
+			return false;
+		}
+		recording << fileHeader << "\n";
+		recordingStarted = true;
+		return true;
+	}
+
+	bool startReplay(const std::string& filename, bool paced) {
+		std::ifstream file(filename);
+		std::string header;
+		if (!std::getline(file, header) || header != fileHeader) {
+			return false;
+		}
+		RecordedKey key;
+		while (file >> key.microseconds >> key.key) {
+			keys.push_back(key);
+		}
+
+		replay::paced = paced;
+		replaying = true;
+		startTime = std::chrono::steady_clock::now();
+		terminal = std::cout.rdbuf(&sink);
+		std::atexit(writeReport);
+		return true;
+	}
+
+	bool isRecording() {
+		return recordingStarted;
+	}
+
+	bool isReplaying() {
+		return replaying;
+	}
+
+	void recordKey(int key) {
+		if (key == Keyboard::noKey || key == Keyboard::endOfInput) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		recording << elapsedMicroseconds() << " " << key << std::endl;
+	}
+
+	int nextKey(int timeoutMs) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (timeoutMs < 0 && turnRunning) {
+			turnLatency.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - turnStart).count()));
+			turnRunning = false;
+		}
+		if (nextIndex >= keys.size()) {
+			return Keyboard::endOfInput;
+		}
+
+		if (paced) {
+			std::int64_t wait = keys[nextIndex].microseconds - elapsedMicroseconds();
+			if (wait > 0) {
+				if (timeoutMs >= 0 && wait > timeoutMs * 1000LL) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+					return Keyboard::noKey;
+				}
+				std::this_thread::sleep_for(std::chrono::microseconds(wait));
+			}
+		}
+		// an unpaced replay hands out keys only when the game waits for one, as a human who typed ahead would be read
+		else if (timeoutMs >= 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+			return Keyboard::noKey;
+		}
+
+		if (timeoutMs < 0) {
+			turnRunning = true;
+			turnStart = std::chrono::steady_clock::now();
+		}
+		return keys[nextIndex++].key;
+	}
+
+	void rejectKey() {
+		std::lock_guard<std::mutex> lock(mutex);
+		turnRunning = false;
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <string>
+
+/**
+* @brief records the keys typed in an interactive session and plays them back through the same game code
+* A recording is a text file with one key per line: microseconds since the program started, then the key code.
+* A replay feeds those keys to every Keyboard instead of the terminal and sends std::cout to a sink that only
+* counts bytes. At exit it reports wall time, the latency of each turn from the key that made a move to the next
+* prompt and the bytes that would have been written to the terminal.
+*/
+namespace replay {
+	/**
+	* @return false if the file could not be written
+	*/
+	bool startRecording(const std::string& filename);
+	/**
+	* @param paced, deliver each key at the time it was recorded instead of as soon as it is asked for
+	* @return false if the file is missing or not a recording
+	*/
+	bool startReplay(const std::string& filename, bool paced);
+	bool isRecording();
+	bool isReplaying();
+	/**
+	* @brief called by Keyboard with every key read from the terminal while recording
+	*/
+	void recordKey(int key);
+	/**
+	* @brief called by Keyboard in place of reading the terminal while replaying
+	* @param timeoutMs, -1 to wait for the next key, otherwise a paced replay only returns a key whose time has come
+	* @return the key, Keyboard::noKey if none is due yet or Keyboard::endOfInput after the last one
+	*/
+	int nextKey(int timeoutMs);
+	/**
+	* @brief called by the game when the last key it waited for did not make a move, so no turn is counted for it
+	*/
+	void rejectKey();
+}
+
+#endif
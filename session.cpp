@@ -0,0 +1,142 @@
+#include "session.hpp"
+#include "utils.hpp"
+
+namespace {
+	const std::uint32_t squareMask = 0x1FF;
+	const int oShift = 9;
+	const std::uint32_t winMasks[8] = { 0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054 };
+
+	bool hasWon(std::uint32_t mask) {
+		for (std::uint32_t winMask : winMasks) {
+			if ((mask & winMask) == winMask) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::uint8_t computerBit(char symbol) {
+		return symbol == 'X' ? 1 : 2;
+	}
+}
+
+SessionStore::SessionStore(std::uint32_t capacity, Engine& engine)
+	: records(new SessionRecord[capacity]), capacity(capacity), activeCount(0), firstFree(0), engine(engine) {
+	for (std::uint32_t i = 0; i < capacity; i++) {
+		records[i] = { i + 1, 'X', 0, SESSION_FREE, 0 };
+	}
+}
+
+SessionHandle SessionStore::create(bool xIsComputer, bool oIsComputer, char firstSymbol) {
+	if (firstFree >= capacity) {
+		return { capacity, 0 };
+	}
+	std::uint32_t index = firstFree;
+	SessionRecord& record = records[index];
+	firstFree = record.cells;
+
+	record.computerMask = (xIsComputer ? computerBit('X') : 0) | (oIsComputer ? computerBit('O') : 0);
+	record.status = SESSION_IN_PROGRESS;
+	activeCount++;
+
+	SessionHandle handle{ index, record.generation };
+	reset(handle, firstSymbol);
+	return handle;
+}
+
+void SessionStore::reset(SessionHandle handle, char firstSymbol) {
+	if (!isValid(handle)) {
+		return;
+	}
+	SessionRecord& record = records[handle.index];
+	record.cells = 0;
+	record.sideToMove = firstSymbol;
+	record.status = SESSION_IN_PROGRESS;
+}
+
+void SessionStore::release(SessionHandle handle) {
+	if (!isValid(handle)) {
+		return;
+	}
+	SessionRecord& record = records[handle.index];
+	record.cells = firstFree;
+	record.status = SESSION_FREE;
+	record.generation++;
+	firstFree = handle.index;
+	activeCount--;
+}
+
+bool SessionStore::isValid(SessionHandle handle) const {
+	return handle.index < capacity
+		&& records[handle.index].status != SESSION_FREE
+		&& records[handle.index].generation == handle.generation;
+}
+
+Board::UpdateStatus SessionStore::play(SessionHandle handle, int squareNum) {
+	if (!isValid(handle) || records[handle.index].status != SESSION_IN_PROGRESS) {
+		return Board::UpdateStatus::failUnknownError;
+	}
+	if (squareNum < 1 || squareNum > 9) {
+		return Board::UpdateStatus::failInvalidInput;
+	}
+	SessionRecord& record = records[handle.index];
+	std::uint32_t bit = 1u << (squareNum - 1);
+	if ((record.cells & bit) || (record.cells & (bit << oShift))) {
+		return Board::UpdateStatus::failSpaceOccupied;
+	}
+	applyMove(record, squareNum - 1);
+	return Board::UpdateStatus::success;
+}
+
+bool SessionStore::advance(SessionHandle handle) {
+	if (!isValid(handle)) {
+		return false;
+	}
+	SessionRecord& record = records[handle.index];
+	if (record.status != SESSION_IN_PROGRESS || !(record.computerMask & computerBit(record.sideToMove))) {
+		return false;
+	}
+	std::pair<int, int> move = engine.findBestMove(getBoard(handle), record.sideToMove);
+	applyMove(record, utils::getSquareNum(move.first, move.second) - 1);
+	return true;
+}
+
+Board SessionStore::getBoard(SessionHandle handle) const {
+	Board board;
+	if (!isValid(handle)) {
+		return board;
+	}
+	std::uint32_t cells = records[handle.index].cells;
+	for (int square = 0; square < 9; square++) {
+		if (cells & (1u << square)) {
+			board.setCell(square / 3, square % 3, 'X');
+		}
+		else if (cells & (1u << (square + oShift))) {
+			board.setCell(square / 3, square % 3, 'O');
+		}
+	}
+	return board;
+}
+
+SessionStatus SessionStore::getStatus(SessionHandle handle) const {
+	return isValid(handle) ? static_cast<SessionStatus>(records[handle.index].status) : SESSION_FREE;
+}
+
+char SessionStore::getSideToMove(SessionHandle handle) const {
+	return isValid(handle) ? records[handle.index].sideToMove : ' ';
+}
+
+void SessionStore::applyMove(SessionRecord& record, int squareIndex) {
+	bool isX = record.sideToMove == 'X';
+	record.cells |= 1u << (squareIndex + (isX ? 0 : oShift));
+
+	std::uint32_t xMask = record.cells & squareMask;
+	std::uint32_t oMask = (record.cells >> oShift) & squareMask;
+	if (hasWon(isX ? xMask : oMask)) {
+		record.status = isX ? SESSION_X_WON : SESSION_O_WON;
+	}
+	else if ((xMask | oMask) == squareMask) {
+		record.status = SESSION_DRAW;
+	}
+	record.sideToMove = isX ? 'O' : 'X';
+}
@@ -0,0 +1,85 @@
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "board.hpp"
+#include "engine.hpp"
+
+enum SessionStatus : std::uint8_t {
+	SESSION_FREE,
+	SESSION_IN_PROGRESS,
+	SESSION_X_WON,
+	SESSION_O_WON,
+	SESSION_DRAW,
+};
+
+/**
+* @brief one game packed into 8 bytes
+* cells holds a 9 bit mask of X squares in the low bits and a 9 bit mask of O squares above it.
+* While the record is free, cells holds the index of the next free record instead.
+* The computer mask and status share a byte so the generation gets 16 bits, a handle only becomes valid
+* again after its slot has been reused 65536 times.
+*/
+struct SessionRecord {
+	std::uint32_t cells;
+	char sideToMove;
+	std::uint8_t computerMask : 2;
+	std::uint8_t status : 6;
+	std::uint16_t generation;
+};
+
+static_assert(sizeof(SessionRecord) == 8, "a session is packed into 8 bytes");
+
+/**
+* @brief refers to a session in a SessionStore, a handle goes stale once its session is released
+*/
+struct SessionHandle {
+	std::uint32_t index;
+	std::uint16_t generation;
+};
+
+/**
+* @brief keeps many games in one contiguous slab of SessionRecords
+* The slab is allocated once when the store is created, so creating, resetting and releasing
+* sessions never touches the heap. All computer players share the engine passed to the store.
+*/
+class SessionStore {
+	public:
+		SessionStore(std::uint32_t capacity, Engine& engine);
+		/**
+		* @brief takes a free record from the slab
+		* @param xIsComputer, oIsComputer, which sides the shared engine plays
+		* @param firstSymbol, 'X' or 'O', the side that moves first
+		* @return the new session, or a handle with index == capacity if the store is full
+		*/
+		SessionHandle create(bool xIsComputer, bool oIsComputer, char firstSymbol = 'X');
+		void reset(SessionHandle handle, char firstSymbol = 'X');
+		void release(SessionHandle handle);
+		bool isValid(SessionHandle handle) const;
+		/**
+		* @brief plays squareNum (1-9) for the side to move
+		*/
+		Board::UpdateStatus play(SessionHandle handle, int squareNum);
+		/**
+		* @brief lets the shared engine move if the side to move is a computer
+		* @return true if a move was played
+		*/
+		bool advance(SessionHandle handle);
+		Board getBoard(SessionHandle handle) const;
+		SessionStatus getStatus(SessionHandle handle) const;
+		char getSideToMove(SessionHandle handle) const;
+		std::uint32_t getCapacity() const { return capacity; }
+		std::uint32_t getActiveCount() const { return activeCount; }
+		std::size_t getMemoryUsage() const { return sizeof(SessionStore) + sizeof(SessionRecord) * capacity; }
+	private:
+		void applyMove(SessionRecord& record, int squareIndex);
+		std::unique_ptr<SessionRecord[]> records;
+		std::uint32_t capacity;
+		std::uint32_t activeCount;
+		std::uint32_t firstFree;
+		Engine& engine;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include "spectator.hpp"
+#include "engine.hpp"
+
+namespace {
+	// percentage of moves played at random, without this every game is the same perfect-play draw
+	const int blunderChance = 10;
+}
+
+Spectator::Spectator(Renderer& renderer, int workerCount, int framesPerSecond)
+	: renderer(renderer), workerCount(workerCount < 1 ? 1 : workerCount),
+	framesPerSecond(framesPerSecond < 1 ? 1 : framesPerSecond), running(false),
+	mailboxes(this->workerCount) {}
+
+void Spectator::run(int seconds) {
+	running = true;
+
+	std::vector<std::thread> workers;
+	for (int i = 0; i < workerCount; i++) {
+		workers.emplace_back(&Spectator::playGames, this, i);
+	}
+
+	renderFrames(seconds);
+
+	running = false;
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void Spectator::playGames(int workerId) {
+	Engine engine(0, false);
+	std::mt19937 rng(std::random_device{}() + workerId);
+	std::uniform_int_distribution<int> randomSquare(1, 9);
+	std::uniform_int_distribution<int> percent(0, 99);
+
+	SpectatorFrame frame;
+	Mailbox<SpectatorFrame>& mailbox = mailboxes[workerId];
+
+	while (running.load(std::memory_order_relaxed)) {
+		Board board;
+		char symbol = 'X';
+		bool firstMove = true;
+
+		while (board.evaluate() == 0 && board.isMovesLeft()) {
+			if (!running.load(std::memory_order_relaxed)) {
+				return;
+			}
+			if (firstMove || percent(rng) < blunderChance) {
+				while (board.updateBoard(randomSquare(rng), symbol) != Board::UpdateStatus::success) {}
+			}
+			else {
+				std::pair<int, int> move = engine.findBestMove(board, symbol);
+				board.setCell(move.first, move.second, symbol);
+			}
+			firstMove = false;
+			symbol = (symbol == 'X') ? 'O' : 'X';
+
+			frame.board = board;
+			mailbox.publish(frame);
+		}
+
+		int eval = board.evaluate();
+		if (eval == +10) {
+			frame.oWins++;
+		}
+		else if (eval == -10) {
+			frame.xWins++;
+		}
+		else {
+			frame.draws++;
+		}
+		frame.gamesPlayed++;
+		mailbox.publish(frame);
+	}
+}
+
+void Spectator::renderFrames(int seconds) {
+	std::vector<SpectatorFrame> latest(workerCount);
+	std::vector<Board> boards(workerCount);
+
+	const std::chrono::microseconds frameTime(1000000 / framesPerSecond);
+	const auto startTime = std::chrono::steady_clock::now();
+	auto nextFrame = startTime;
+
+	while (true) {
+		int gamesPlayed = 0, xWins = 0, oWins = 0, draws = 0;
+		for (int i = 0; i < workerCount; i++) {
+			mailboxes[i].fetch(latest[i]);
+			boards[i] = latest[i].board;
+			gamesPlayed += latest[i].gamesPlayed;
+			xWins += latest[i].xWins;
+			oWins += latest[i].oWins;
+			draws += latest[i].draws;
+		}
+
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		int gamesPerSecond = elapsed > 0 ? static_cast<int>(gamesPlayed / elapsed) : 0;
+		std::string statusMessage = "Games: " + std::to_string(gamesPlayed)
+			+ "  X wins: " + std::to_string(xWins)
+			+ "  O wins: " + std::to_string(oWins)
+			+ "  Draws: " + std::to_string(draws)
+			+ "  (" + std::to_string(gamesPerSecond) + " games/s)";
+
+		renderer.clearScreen();
+		renderer.renderSpectatorScreen(boards, statusMessage);
+
+		if (seconds > 0 && elapsed >= seconds) {
+			break;
+		}
+
+		// frames that fall behind are skipped rather than drawn late
+		nextFrame += frameTime;
+		auto now = std::chrono::steady_clock::now();
+		if (nextFrame < now) {
+			nextFrame = now;
+		}
+		std::this_thread::sleep_until(nextFrame);
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef SPECTATOR_HPP
+#define SPECTATOR_HPP
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include "board.hpp"
+#include "renderer.hpp"
+
+/**
+* @brief lock-free single-slot mailbox between one producer and one consumer
+* The producer never waits and always overwrites the slot, so the consumer only sees the latest value
+* and anything published in between two fetches is dropped. Internally this is a triple buffer:
+* one buffer for the writer, one for the reader and one shared slot swapped with an atomic exchange.
+*/
+template <typename T>
+class Mailbox {
+	public:
+		void publish(const T& value) {
+			buffers[writeIndex] = value;
+			writeIndex = slot.exchange(writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+		}
+		/**
+		* @brief copies the latest published value into value
+		* @return false if nothing new was published since the last fetch
+		*/
+		bool fetch(T& value) {
+			if ((slot.load(std::memory_order_acquire) & freshBit) == 0) {
+				return false;
+			}
+			readIndex = slot.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+			value = buffers[readIndex];
+			return true;
+		}
+	private:
+		static const int indexMask = 3;
+		static const int freshBit = 4;
+		std::array<T, 3> buffers{};
+		std::atomic<int> slot{ 1 };
+		int writeIndex = 0;
+		int readIndex = 2;
+};
+
+struct SpectatorFrame {
+	Board board;
+	int gamesPlayed = 0;
+	int xWins = 0;
+	int oWins = 0;
+	int draws = 0;
+};
+
+/**
+* @brief runs computer-vs-computer games at full speed on worker threads while a separate
+* render thread draws the latest position of every game at a fixed frame rate
+*/
+class Spectator {
+	public:
+		Spectator(Renderer& renderer, int workerCount, int framesPerSecond = 30);
+		/**
+		* @brief plays games until the given number of seconds has passed, or forever if seconds <= 0
+		*/
+		void run(int seconds);
+	private:
+		void playGames(int workerId);
+		void renderFrames(int seconds);
+		Renderer& renderer;
+		int workerCount;
+		int framesPerSecond;
+		std::atomic<bool> running;
+		std::vector<Mailbox<SpectatorFrame>> mailboxes;
+};
+
+#endif
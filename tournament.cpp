@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+#include "tournament.hpp"
+#include "board.hpp"
+#include "engine.hpp"
+#include "policies.hpp"
+#include "utils.hpp"
+
+namespace {
+	double toElo(double score) {
+		return -400.0 * std::log10(1.0 / score - 1.0);
+	}
+
+	bool parseNumber(const std::string& text, int& value) {
+		if (text.empty() || text.size() > 6 || !std::all_of(text.begin(), text.end(), ::isdigit)) {
+			return false;
+		}
+		value = std::stoi(text);
+		return value > 0;
+	}
+}
+
+bool parseTournamentConfig(const std::string& name, TournamentConfig& config) {
+	config = { name, 0, 0, false, 0 };
+	if (name == "minimax") {
+		return true;
+	}
+	if (name == "random") {
+		config.random = true;
+		return true;
+	}
+	if (name.rfind("depth", 0) == 0) {
+		return parseNumber(name.substr(5), config.maxDepth);
+	}
+	if (name.rfind("time", 0) == 0 && name.size() > 6 && name.compare(name.size() - 2, 2, "ms") == 0) {
+		return parseNumber(name.substr(4, name.size() - 6), config.moveTime);
+	}
+	if (name.rfind("nodes", 0) == 0) {
+		return parseNumber(name.substr(5), config.nodeBudget);
+	}
+	return false;
+}
+
+Tournament::Tournament(const std::vector<TournamentConfig>& configs, int gamesPerPairing, int openingPlies)
+	: configs(configs), gamesPerPairing(gamesPerPairing < 2 ? 2 : gamesPerPairing + gamesPerPairing % 2),
+	openingPlies(openingPlies < 0 ? 0 : openingPlies), standings(configs.size()) {
+	for (int first = 0; first < static_cast<int>(configs.size()); first++) {
+		for (int second = first + 1; second < static_cast<int>(configs.size()); second++) {
+			pairings.push_back({ first, second });
+		}
+	}
+}
+
+double Tournament::run(int threadCount) {
+	if (threadCount < 1) {
+		threadCount = 1;
+	}
+	int gameCount = static_cast<int>(pairings.size()) * gamesPerPairing;
+	std::atomic<int> nextGame{ 0 };
+	auto startTime = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; i++) {
+		threads.emplace_back(&Tournament::playGames, this, std::ref(nextGame), gameCount);
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Tournament::playGames(std::atomic<int>& nextGame, int gameCount) {
+	for (int game = nextGame++; game < gameCount; game = nextGame++) {
+		const std::pair<int, int>& pairing = pairings[game / gamesPerPairing];
+		playGame(pairing.first, pairing.second, game);
+	}
+}
+
+void Tournament::playGame(int first, int second, int gameIndex) {
+	// both games of a colour-swapped pair share a seed, so they start from the same opening
+	std::mt19937 rng(static_cast<unsigned>(gameIndex / 2));
+	bool firstPlaysX = gameIndex % 2 == 0;
+	int xIndex = firstPlaysX ? first : second;
+	int oIndex = firstPlaysX ? second : first;
+
+	Board board;
+	RandomPolicy opening(rng());
+	int plies = std::uniform_int_distribution<int>(0, openingPlies)(rng);
+	char symbol = 'X';
+	for (int ply = 0; ply < plies; ply++) {
+		board.updateBoard(opening.chooseMove(board, symbol), symbol);
+		symbol = (symbol == 'X') ? 'O' : 'X';
+	}
+
+	Engine engines[2] = { Engine(0, false), Engine(0, false) };
+	RandomPolicy randomPolicies[2] = { RandomPolicy(rng()), RandomPolicy(rng()) };
+	int indices[2] = { xIndex, oIndex };
+	for (int side = 0; side < 2; side++) {
+		engines[side].setSearchLimits(configs[indices[side]].maxDepth, configs[indices[side]].moveTime,
+			static_cast<std::uint64_t>(configs[indices[side]].nodeBudget));
+	}
+
+	int eval = board.evaluate();
+	while (eval == 0 && board.isMovesLeft()) {
+		int side = symbol == 'X' ? 0 : 1;
+		const TournamentConfig& config = configs[indices[side]];
+		Standing& standing = standings[indices[side]];
+
+		auto startTime = std::chrono::steady_clock::now();
+		std::uint64_t nodesBefore = engines[side].getNodeCount();
+		int squareNum;
+		if (config.random) {
+			squareNum = randomPolicies[side].chooseMove(board, symbol);
+		}
+		else {
+			std::pair<int, int> move = engines[side].findBestMove(board, symbol);
+			squareNum = utils::getSquareNum(move.first, move.second);
+		}
+		auto elapsed = std::chrono::steady_clock::now() - startTime;
+
+		standing.latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		standing.moves++;
+		if (!config.random) {
+			standing.searchedMoves++;
+			standing.nodes += engines[side].getNodeCount() - nodesBefore;
+		}
+
+		board.updateBoard(squareNum, symbol);
+		symbol = (symbol == 'X') ? 'O' : 'X';
+		eval = board.evaluate();
+	}
+
+	if (eval == 0) {
+		standings[xIndex].draws++;
+		standings[oIndex].draws++;
+	}
+	else {
+		int winner = eval == +10 ? oIndex : xIndex;
+		int loser = eval == +10 ? xIndex : oIndex;
+		standings[winner].wins++;
+		standings[loser].losses++;
+	}
+}
+
+void Tournament::writeReport(std::ostream& out) const {
+	out << std::left << std::setw(12) << "config" << std::right
+		<< std::setw(7) << "games" << std::setw(7) << "wins" << std::setw(7) << "draws" << std::setw(7) << "losses"
+		<< std::setw(16) << "elo" << std::setw(12) << "nodes/move"
+		<< std::setw(11) << "p50 (us)" << std::setw(11) << "p99 (us)" << std::endl;
+
+	for (std::size_t i = 0; i < configs.size(); i++) {
+		const Standing& standing = standings[i];
+		int wins = standing.wins, draws = standing.draws, losses = standing.losses;
+		int games = wins + draws + losses;
+
+		std::string elo = "-";
+		if (games > 0) {
+			// score fraction and its standard error per game, kept half a game away from 0 and 1 so the rating stays finite
+			double score = (wins + 0.5 * draws) / games;
+			double variance = (wins * std::pow(1 - score, 2) + draws * std::pow(0.5 - score, 2) + losses * std::pow(score, 2)) / games;
+			double margin = 1.96 * std::sqrt(variance / games);
+			double lowest = 0.5 / games, highest = 1 - lowest;
+			double rating = toElo(std::clamp(score, lowest, highest));
+			double errorBar = (toElo(std::clamp(score + margin, lowest, highest)) - toElo(std::clamp(score - margin, lowest, highest))) / 2;
+
+			std::ostringstream text;
+			text << std::fixed << std::setprecision(0) << std::showpos << rating << std::noshowpos << " +/- " << errorBar;
+			elo = text.str();
+		}
+
+		std::uint64_t searchedMoves = standing.searchedMoves;
+		std::string nodesPerMove = searchedMoves > 0 ? std::to_string(standing.nodes / searchedMoves) : "-";
+
+		out << std::left << std::setw(12) << configs[i].name << std::right
+			<< std::setw(7) << games << std::setw(7) << wins << std::setw(7) << draws << std::setw(7) << losses
+			<< std::setw(16) << elo << std::setw(12) << nodesPerMove
+			<< std::fixed << std::setprecision(1)
+			<< std::setw(11) << standing.latency.getPercentile(50) / 1000.0
+			<< std::setw(11) << standing.latency.getPercentile(99) / 1000.0 << std::endl;
+	}
+}
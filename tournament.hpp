@@ -0,0 +1,72 @@
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "profiler.hpp"
+
+/**
+* @brief an engine configuration that takes part in a tournament
+* Named "minimax" for the full search, "depthN" for a search N plies deep, "timeNms" for N milliseconds per move,
+* "nodesN" for N positions per move or "random".
+*/
+struct TournamentConfig {
+	std::string name;
+	int maxDepth;
+	int moveTime;
+	bool random;
+	int nodeBudget;
+};
+
+/**
+* @param name, a configuration name as described above
+* @param config, set to the parsed configuration
+* @return false if the name is not recognised
+*/
+bool parseTournamentConfig(const std::string& name, TournamentConfig& config);
+
+/**
+* @brief plays a round robin between engine configurations and reports strength and cost per move
+* Every pair of configurations plays gamesPerPairing games. Games come in pairs that start from the same random
+* opening, once with each side playing X, so neither the opening nor moving first favours anybody. Games are
+* shared out between threads, and every thread records into the same atomic counters and histograms.
+*/
+class Tournament {
+	public:
+		/**
+		* @param gamesPerPairing, rounded up to an even number so colours are swapped evenly
+		* @param openingPlies, the most random moves played before the engines take over
+		*/
+		Tournament(const std::vector<TournamentConfig>& configs, int gamesPerPairing, int openingPlies = 2);
+		/**
+		* @return seconds taken
+		*/
+		double run(int threadCount);
+		/**
+		* @brief writes win/draw/loss, Elo with a 95% error bar, nodes per move and p50/p99 move latency of every configuration
+		* Elo is a performance rating against the other configurations, so the ratings are relative to each other.
+		*/
+		void writeReport(std::ostream& out) const;
+	private:
+		struct Standing {
+			std::atomic<int> wins{ 0 };
+			std::atomic<int> draws{ 0 };
+			std::atomic<int> losses{ 0 };
+			std::atomic<std::uint64_t> moves{ 0 };
+			std::atomic<std::uint64_t> searchedMoves{ 0 };
+			std::atomic<std::uint64_t> nodes{ 0 };
+			profiler::Histogram latency;
+		};
+		void playGames(std::atomic<int>& nextGame, int gameCount);
+		void playGame(int first, int second, int gameIndex);
+		std::vector<TournamentConfig> configs;
+		std::vector<std::pair<int, int>> pairings;
+		int gamesPerPairing;
+		int openingPlies;
+		std::vector<Standing> standings;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "tracer.hpp"
+
+namespace tracer {
+
+	namespace {
+		struct Event {
+			const char* name;
+			const char* category;
+			char phase;
+			std::int64_t start;
+			std::int64_t duration;
+			const char* argName;
+			long long argValue;
+		};
+
+		struct ThreadBuffer {
+			int threadId;
+			std::vector<Event> events;
+		};
+
+		std::atomic<bool> enabled{ false };
+		std::string outputFile;
+		const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+		// the buffers outlive their threads so events from workers that have finished are still written
+		std::mutex buffersMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		thread_local ThreadBuffer* threadBuffer = nullptr;
+
+		ThreadBuffer& getThreadBuffer() {
+			if (!threadBuffer) {
+				std::lock_guard<std::mutex> lock(buffersMutex);
+				buffers.push_back(std::make_unique<ThreadBuffer>());
+				buffers.back()->threadId = static_cast<int>(buffers.size());
+				buffers.back()->events.reserve(4096);
+				threadBuffer = buffers.back().get();
+			}
+			return *threadBuffer;
+		}
+
+		std::int64_t toNanoseconds(std::chrono::steady_clock::time_point time) {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(time - startTime).count();
+		}
+
+		void writeMicroseconds(std::ostream& out, std::int64_t nanoseconds) {
+			out << nanoseconds / 1000 << "." << (nanoseconds % 1000) / 100 << (nanoseconds % 100) / 10 << nanoseconds % 10;
+		}
+
+		void writeEvent(std::ostream& out, const Event& event, int threadId) {
+			out << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase
+				<< "\",\"pid\":1,\"tid\":" << threadId << ",\"ts\":";
+			writeMicroseconds(out, event.start);
+			if (event.phase == 'X') {
+				out << ",\"dur\":";
+				writeMicroseconds(out, event.duration);
+			}
+			if (event.argName) {
+				out << ",\"args\":{\"" << event.argName << "\":" << event.argValue << "}";
+			}
+			out << "}";
+		}
+	}
+
+	void start(const std::string& filename) {
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+			if (!outputFile.empty()) {
+				return;
+			}
+			outputFile = filename;
+		}
+		// the thread that starts tracing gets the first buffer and is named main in the trace
+		getThreadBuffer();
+		enabled = true;
+		std::atexit(flush);
+	}
+
+	bool isEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	void flush() {
+		enabled = false;
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		if (outputFile.empty()) {
+			return;
+		}
+		std::ofstream out(outputFile);
+		if (!out) {
+			return;
+		}
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		for (const auto& buffer : buffers) {
+			out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+				<< ",\"args\":{\"name\":\"" << (buffer->threadId == 1 ? "main" : "worker ") ;
+			if (buffer->threadId != 1) {
+				out << buffer->threadId - 1;
+			}
+			out << "\"}}";
+			first = false;
+			for (const Event& event : buffer->events) {
+				out << ",\n";
+				writeEvent(out, event, buffer->threadId);
+			}
+			buffer->events.clear();
+		}
+		out << "\n]}\n";
+	}
+
+	Span::Span(const char* name, const char* category, const char* argName, long long argValue)
+		: name(name), category(category), argName(argName), argValue(argValue), enabled(isEnabled()) {
+		if (enabled) {
+			startTime = std::chrono::steady_clock::now();
+		}
+	}
+
+	Span::~Span() {
+		if (!enabled || !isEnabled()) {
+			return;
+		}
+		std::int64_t start = toNanoseconds(startTime);
+		std::int64_t end = toNanoseconds(std::chrono::steady_clock::now());
+		getThreadBuffer().events.push_back({ name, category, 'X', start, end - start, argName, argValue });
+	}
+
+	void counter(const char* name, long long value) {
+		if (!isEnabled()) {
+			return;
+		}
+		getThreadBuffer().events.push_back({ name, "counter", 'C', toNanoseconds(std::chrono::steady_clock::now()), 0, name, value });
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+* Opt-in timeline of a session in the Chrome trace event format, for chrome://tracing or ui.perfetto.dev.
+* Nothing is recorded until start() is called. Every thread appends events to its own buffer without locking,
+* and the buffers are written out together by flush(), which start() also arranges to run at exit.
+* Event names, categories and argument names must be string literals, only pointers to them are kept.
+*/
+namespace tracer {
+	/**
+	* @brief starts recording, events are written to filename when the program exits
+	*/
+	void start(const std::string& filename);
+	/**
+	* @brief writes every buffer to the file given to start() and stops recording
+	* Call it only when no other thread is recording, the exit handler runs after main() returns.
+	*/
+	void flush();
+	bool isEnabled();
+
+	/**
+	* @brief records how long it lives as one complete event on the calling thread
+	*/
+	class Span {
+		public:
+			Span(const char* name, const char* category, const char* argName = nullptr, long long argValue = 0);
+			~Span();
+			Span(const Span&) = delete;
+			Span& operator=(const Span&) = delete;
+		private:
+			const char* name;
+			const char* category;
+			const char* argName;
+			long long argValue;
+			std::chrono::steady_clock::time_point startTime;
+			bool enabled;
+	};
+
+	/**
+	* @brief records the value of a counter, drawn as a graph under the threads
+	*/
+	void counter(const char* name, long long value);
+}
+
+#endif
@@ -0,0 +1,171 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "positions.hpp"
+#include "trainer.hpp"
+
+namespace {
+	const char fileMagic[4] = { 'T', 'T', 'T', 'V' };
+	const std::uint32_t fileVersion = 2;
+	const int powersOfThree[9] = { 1, 3, 9, 27, 81, 243, 729, 2187, 6561 };
+
+	// the side that started has a stone more, or as many when it is its turn again
+	bool startedWithX(int code, char toMove) {
+		int balance = 0;
+		for (; code > 0; code /= 3) {
+			balance += code % 3 == 1 ? 1 : code % 3 == 2 ? -1 : 0;
+		}
+		return balance > 0 || (balance == 0 && toMove == 'X');
+	}
+}
+
+ValueTable::ValueTable() : values(new std::atomic<float>[PositionIndex::positionCount]) {
+	for (int index = 0; index < PositionIndex::positionCount; index++) {
+		values[index].store(0.0f, std::memory_order_relaxed);
+	}
+}
+
+ValueTable::Key ValueTable::keyOf(int code, bool xStarted) {
+	if (xStarted) {
+		return { PositionIndex::indexOf(code), 1.0f };
+	}
+	return { PositionIndex::indexOf(PositionIndex::swapColours(code)), -1.0f };
+}
+
+void ValueTable::update(Key key, float target, float alpha) {
+	if (key.index < 0) {
+		return;
+	}
+	std::atomic<float>& value = values[key.index];
+	target *= key.sign;
+	float current = value.load(std::memory_order_relaxed);
+	while (!value.compare_exchange_weak(current, current + alpha * (target - current), std::memory_order_relaxed)) {}
+}
+
+int ValueTable::chooseMove(const Board& board, char symbol) const {
+	int code = board.toCode();
+	bool xStarted = startedWithX(code, symbol);
+	int digit = symbol == 'X' ? 1 : 2;
+	int bestSquare = -1;
+	float bestValue = 0.0f;
+
+	for (int square = 0; square < 9; square++) {
+		if (board.getCell(square / 3, square % 3) != ' ') {
+			continue;
+		}
+		float value = get(keyOf(code + digit * powersOfThree[square], xStarted));
+		if (bestSquare == -1 || (symbol == 'O' ? value > bestValue : value < bestValue)) {
+			bestValue = value;
+			bestSquare = square + 1;
+		}
+	}
+	return bestSquare;
+}
+
+bool ValueTable::save(const std::string& filename) const {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	std::vector<float> snapshot(PositionIndex::positionCount);
+	for (int index = 0; index < PositionIndex::positionCount; index++) {
+		snapshot[index] = values[index].load(std::memory_order_relaxed);
+	}
+	std::uint32_t count = PositionIndex::positionCount;
+	file.write(fileMagic, sizeof(fileMagic));
+	file.write(reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion));
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+	file.write(reinterpret_cast<const char*>(snapshot.data()), sizeof(float) * snapshot.size());
+	return static_cast<bool>(file);
+}
+
+bool ValueTable::load(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	char magic[4];
+	std::uint32_t version = 0, count = 0;
+	file.read(magic, sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	file.read(reinterpret_cast<char*>(&count), sizeof(count));
+	if (!file || std::memcmp(magic, fileMagic, sizeof(magic)) != 0 || version != fileVersion || count != PositionIndex::positionCount) {
+		return false;
+	}
+	std::vector<float> snapshot(PositionIndex::positionCount);
+	file.read(reinterpret_cast<char*>(snapshot.data()), sizeof(float) * snapshot.size());
+	if (!file) {
+		return false;
+	}
+	for (int index = 0; index < PositionIndex::positionCount; index++) {
+		values[index].store(snapshot[index], std::memory_order_relaxed);
+	}
+	return true;
+}
+
+Trainer::Trainer(ValueTable& table, float alpha, float epsilon) : table(table), alpha(alpha), epsilon(epsilon) {}
+
+double Trainer::train(long long episodes, int threadCount) {
+	if (threadCount < 1) {
+		threadCount = 1;
+	}
+	auto startTime = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; i++) {
+		long long share = episodes / threadCount + (i < episodes % threadCount ? 1 : 0);
+		threads.emplace_back(&Trainer::playEpisodes, this, share, static_cast<unsigned>(i + 1));
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return elapsed > 0 ? episodes / elapsed : 0;
+}
+
+void Trainer::playEpisodes(long long episodes, unsigned seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+	std::uniform_int_distribution<int> coinFlip(0, 1);
+
+	for (long long episode = 0; episode < episodes; episode++) {
+		Board board;
+		// both sides get to move first, so the table also covers games where O starts
+		char symbol = coinFlip(rng) ? 'X' : 'O';
+		bool xStarted = symbol == 'X';
+		ValueTable::Key visited[9];
+		int visitedCount = 0;
+		int eval = 0;
+
+		while (eval == 0 && board.isMovesLeft()) {
+			int squareNum = -1;
+			if (chance(rng) < epsilon) {
+				int emptySquares[9];
+				int emptyCount = 0;
+				for (int square = 0; square < 9; square++) {
+					if (board.getCell(square / 3, square % 3) == ' ') {
+						emptySquares[emptyCount++] = square + 1;
+					}
+				}
+				squareNum = emptySquares[std::uniform_int_distribution<int>(0, emptyCount - 1)(rng)];
+			}
+			else {
+				squareNum = table.chooseMove(board, symbol);
+			}
+
+			board.updateBoard(squareNum, symbol);
+			visited[visitedCount++] = ValueTable::keyOf(board.toCode(), xStarted);
+			symbol = (symbol == 'X') ? 'O' : 'X';
+			eval = board.evaluate();
+		}
+
+		// working backwards lets the result reach every position of the game in a single episode
+		float target = eval == +10 ? 1.0f : eval == -10 ? -1.0f : 0.0f;
+		for (int i = visitedCount - 1; i >= 0; i--) {
+			table.update(visited[i], target, alpha);
+			target = table.get(visited[i]);
+		}
+	}
+}
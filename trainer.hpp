@@ -0,0 +1,75 @@
+#ifndef TRAINER_HPP
+#define TRAINER_HPP
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "board.hpp"
+
+/**
+* @brief learned value of every reachable 3x3 position, indexed by PositionIndex
+* A value is the expected result for O of the position reached after a move: +1 an O win, -1 an X win, 0 a draw.
+* A position from a game O started is kept as the same position with X and O swapped and its value negated,
+* so games either side starts train the same entries. Entries are atomics so training threads can update the
+* shared table without locks.
+*/
+class ValueTable {
+	public:
+		/**
+		* @brief where the value of a position is kept, sign is -1 if the colours were swapped to get there
+		*/
+		struct Key {
+			int index;
+			float sign;
+		};
+		ValueTable();
+		/**
+		* @param code, Board::toCode() of the position
+		* @param xStarted, whether X made the first move of the game
+		* @return index -1 if no game can reach the position
+		*/
+		static Key keyOf(int code, bool xStarted);
+		float get(Key key) const { return key.index < 0 ? 0.0f : key.sign * values[key.index].load(std::memory_order_relaxed); }
+		/**
+		* @brief moves the value of key a fraction alpha of the way towards target
+		*/
+		void update(Key key, float target, float alpha);
+		/**
+		* @return the square (1-9) whose resulting position has the best value for symbol, or -1 if the board is full
+		*/
+		int chooseMove(const Board& board, char symbol) const;
+		/**
+		* @brief writes the table to a compact binary checkpoint: a header followed by one float per position
+		* @return false if the file could not be written
+		*/
+		bool save(const std::string& filename) const;
+		/**
+		* @return false if the file is missing or was not written by a compatible version
+		*/
+		bool load(const std::string& filename);
+	private:
+		std::unique_ptr<std::atomic<float>[]> values;
+};
+
+/**
+* @brief learns a ValueTable from self-play, one episode per game
+* Every thread plays epsilon-greedy games against itself and, once a game ends, moves the value of each
+* position towards the value of the position after it, the last one towards the result of the game.
+* Threads write straight into the shared table.
+*/
+class Trainer {
+	public:
+		Trainer(ValueTable& table, float alpha = 0.1f, float epsilon = 0.1f);
+		/**
+		* @brief plays the given number of episodes split over threadCount threads
+		* @return episodes played per second
+		*/
+		double train(long long episodes, int threadCount);
+	private:
+		void playEpisodes(long long episodes, unsigned seed);
+		ValueTable& table;
+		float alpha;
+		float epsilon;
+};
+
+#endif
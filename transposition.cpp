@@ -0,0 +1,378 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "evaluation_weights.hpp"
+#include "transposition.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	const char tableMagic[8] = { 'T', 'T', 'T', 'T', 'A', 'B', 'L', 'E' };
+	const char fileMagic[8] = { 'T', 'T', 'T', 'C', 'A', 'C', 'H', 'E' };
+	const std::uint32_t formatVersion = 1;
+
+	// FNV-1a step over the four bytes of value
+	constexpr std::uint32_t mixHash(std::uint32_t hash, std::uint32_t value) {
+		for (int byte = 0; byte < 4; byte++) {
+			hash = (hash ^ ((value >> (8 * byte)) & 0xFF)) * 16777619u;
+		}
+		return hash;
+	}
+
+	constexpr std::uint32_t weightsHash() {
+		std::uint32_t hash = mixHash(2166136261u, static_cast<std::uint32_t>(evaluationWeights::centre));
+		for (int weight : evaluationWeights::openWindows) {
+			hash = mixHash(hash, static_cast<std::uint32_t>(weight));
+		}
+		for (int weight : evaluationWeights::blockedWindows) {
+			hash = mixHash(hash, static_cast<std::uint32_t>(weight));
+		}
+		return hash;
+	}
+
+	// the version in file and shared-memory headers. Depth-limited scores are only as good as the weights
+	// that made them, so a build with retuned weights refuses the tables of the old one
+	constexpr std::uint32_t tableVersion = mixHash(weightsHash(), TranspositionTable::engineVersion);
+	// entries are read and written this many at a time
+	const std::size_t fileChunk = 4096;
+
+	struct FileHeader {
+		char magic[8];
+		std::uint32_t formatVersion;
+		std::uint32_t engineVersion;
+		std::uint64_t entryCount;
+	};
+
+	struct FileEntry {
+		std::uint64_t key;
+		std::uint64_t data;
+	};
+
+	// the table persist() keeps saving, its background thread and what stops it at exit
+	struct Persisted {
+		std::shared_ptr<TranspositionTable> table;
+		std::string filename;
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable stopped;
+		bool stopping = false;
+	};
+
+	Persisted& persisted() {
+		static Persisted instance;
+		return instance;
+	}
+
+	void saveAtExit() {
+		Persisted& state = persisted();
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+			state.stopping = true;
+		}
+		state.stopped.notify_all();
+		if (state.thread.joinable()) {
+			state.thread.join();
+		}
+		if (state.table) {
+			state.table->save(state.filename);
+		}
+	}
+	const std::uint64_t validBit = std::uint64_t(1) << 63;
+	// how long an attaching process waits for the creating process to finish setting the table up
+	const int attachAttempts = 1000;
+
+	std::size_t roundDownToPowerOfTwo(std::size_t value) {
+		std::size_t result = 1;
+		while (result * 2 <= value) {
+			result *= 2;
+		}
+		return result;
+	}
+
+	// the score takes 32 bits, heuristic scores from a depth-limited search go far past 16
+	std::uint64_t pack(const TranspositionTable::Entry& entry) {
+		return validBit
+			| static_cast<std::uint64_t>(static_cast<std::uint32_t>(entry.score))
+			| static_cast<std::uint64_t>(entry.bound & 3) << 32
+			| static_cast<std::uint64_t>(entry.depth & 0xFF) << 34
+			| static_cast<std::uint64_t>((entry.bestSquare + 1) & 0xFF) << 42;
+	}
+
+	TranspositionTable::Entry unpack(std::uint64_t data) {
+		return {
+			static_cast<int>(static_cast<std::int32_t>(data & 0xFFFFFFFF)),
+			static_cast<TranspositionTable::Bound>((data >> 32) & 3),
+			static_cast<int>((data >> 34) & 0xFF),
+			static_cast<int>((data >> 42) & 0xFF) - 1,
+		};
+	}
+}
+
+TranspositionTable::TranspositionTable(std::size_t entryCount) {
+	this->entryCount = roundDownToPowerOfTwo(entryCount);
+	mappingLength = mappingSize(this->entryCount);
+	mapping = std::calloc(1, mappingLength);
+	header = static_cast<Header*>(mapping);
+	slots = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(Header));
+	initialiseHeader();
+}
+
+TranspositionTable::~TranspositionTable() {
+	if (!mapping) {
+		return;
+	}
+	if (!shared) {
+		std::free(mapping);
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(mapping);
+	CloseHandle(static_cast<HANDLE>(mappingHandle));
+#else
+	munmap(mapping, mappingLength);
+#endif
+}
+
+std::size_t TranspositionTable::mappingSize(std::size_t entryCount) {
+	return sizeof(Header) + sizeof(Slot) * entryCount;
+}
+
+void TranspositionTable::initialiseHeader() {
+	std::memcpy(header->magic, tableMagic, sizeof(tableMagic));
+	header->formatVersion = formatVersion;
+	header->engineVersion = tableVersion;
+	header->entryCount = entryCount;
+	header->ready.store(1, std::memory_order_release);
+}
+
+bool TranspositionTable::hasCompatibleHeader() const {
+	return std::memcmp(header->magic, tableMagic, sizeof(tableMagic)) == 0
+		&& header->formatVersion == formatVersion
+		&& header->engineVersion == tableVersion
+		&& header->entryCount > 0
+		&& mappingSize(header->entryCount) <= mappingLength;
+}
+
+std::unique_ptr<TranspositionTable> TranspositionTable::attachShared(const std::string& name, std::size_t entryCount) {
+	std::unique_ptr<TranspositionTable> table(new TranspositionTable());
+	table->shared = true;
+	entryCount = roundDownToPowerOfTwo(entryCount);
+	std::size_t length = mappingSize(entryCount);
+	bool created = false;
+
+#ifdef _WIN32
+	std::string mappingName = "Local\\" + name;
+	HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(static_cast<std::uint64_t>(length) >> 32), static_cast<DWORD>(length & 0xFFFFFFFF), mappingName.c_str());
+	if (!handle) {
+		return nullptr;
+	}
+	created = GetLastError() != ERROR_ALREADY_EXISTS;
+	void* mapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (!mapping) {
+		CloseHandle(handle);
+		return nullptr;
+	}
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(mapping, &info, sizeof(info));
+	table->mappingHandle = handle;
+	table->mapping = mapping;
+	table->mappingLength = info.RegionSize;
+#else
+	std::string shmName = (!name.empty() && name[0] == '/') ? name : "/" + name;
+	int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd >= 0) {
+		created = true;
+		if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+			close(fd);
+			shm_unlink(shmName.c_str());
+			return nullptr;
+		}
+	}
+	else if (errno == EEXIST) {
+		fd = shm_open(shmName.c_str(), O_RDWR, 0600);
+		if (fd < 0) {
+			return nullptr;
+		}
+		// the creating process may not have sized the segment yet
+		struct stat info {};
+		for (int attempt = 0; fstat(fd, &info) == 0 && info.st_size == 0 && attempt < attachAttempts; attempt++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		if (info.st_size < static_cast<off_t>(sizeof(Header))) {
+			close(fd);
+			return nullptr;
+		}
+		length = static_cast<std::size_t>(info.st_size);
+	}
+	else {
+		return nullptr;
+	}
+	void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		return nullptr;
+	}
+	table->mapping = mapping;
+	table->mappingLength = length;
+#endif
+
+	table->header = static_cast<Header*>(table->mapping);
+	table->slots = reinterpret_cast<Slot*>(static_cast<char*>(table->mapping) + sizeof(Header));
+
+	if (created) {
+		table->entryCount = entryCount;
+		table->initialiseHeader();
+		return table;
+	}
+
+	for (int attempt = 0; table->header->ready.load(std::memory_order_acquire) == 0; attempt++) {
+		if (attempt >= attachAttempts) {
+			return nullptr;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if (!table->hasCompatibleHeader()) {
+		return nullptr;
+	}
+	table->entryCount = static_cast<std::size_t>(table->header->entryCount);
+	return table;
+}
+
+void TranspositionTable::removeShared(const std::string& name) {
+#ifndef _WIN32
+	std::string shmName = (!name.empty() && name[0] == '/') ? name : "/" + name;
+	shm_unlink(shmName.c_str());
+#endif
+}
+
+std::size_t TranspositionTable::indexOf(std::uint64_t key) const {
+	// splitmix64 finaliser, so keys that differ in a few low bits still spread over the whole table
+	key ^= key >> 30;
+	key *= 0xBF58476D1CE4E5B9ULL;
+	key ^= key >> 27;
+	key *= 0x94D049BB133111EBULL;
+	key ^= key >> 31;
+	return static_cast<std::size_t>(key & (entryCount - 1));
+}
+
+bool TranspositionTable::save(const std::string& filename) const {
+	std::string temporaryName = filename + ".tmp";
+	{
+		std::ofstream file(temporaryName, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		FileHeader fileHeader{};
+		std::memcpy(fileHeader.magic, fileMagic, sizeof(fileMagic));
+		fileHeader.formatVersion = formatVersion;
+		fileHeader.engineVersion = tableVersion;
+		// the count is filled in once the entries are written
+		file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+
+		std::vector<FileEntry> chunk;
+		chunk.reserve(fileChunk);
+		for (std::size_t i = 0; i < entryCount; i++) {
+			std::uint64_t data = slots[i].data.load(std::memory_order_relaxed);
+			std::uint64_t check = slots[i].check.load(std::memory_order_relaxed);
+			// a slot a store has only half written belongs to a different index than its key
+			if (!(data & validBit) || indexOf(check ^ data) != i) {
+				continue;
+			}
+			chunk.push_back({ check ^ data, data });
+			if (chunk.size() == fileChunk) {
+				file.write(reinterpret_cast<const char*>(chunk.data()), sizeof(FileEntry) * chunk.size());
+				fileHeader.entryCount += chunk.size();
+				chunk.clear();
+			}
+		}
+		file.write(reinterpret_cast<const char*>(chunk.data()), sizeof(FileEntry) * chunk.size());
+		fileHeader.entryCount += chunk.size();
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+		if (!file) {
+			return false;
+		}
+	}
+#ifdef _WIN32
+	// rename does not replace an existing file on Windows
+	std::remove(filename.c_str());
+#endif
+	return std::rename(temporaryName.c_str(), filename.c_str()) == 0;
+}
+
+bool TranspositionTable::load(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	FileHeader fileHeader{};
+	file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+	if (!file || std::memcmp(fileHeader.magic, fileMagic, sizeof(fileMagic)) != 0
+		|| fileHeader.formatVersion != formatVersion || fileHeader.engineVersion != tableVersion) {
+		return false;
+	}
+
+	std::vector<FileEntry> chunk(fileChunk);
+	for (std::uint64_t remaining = fileHeader.entryCount; remaining > 0;) {
+		std::size_t count = static_cast<std::size_t>(remaining < fileChunk ? remaining : fileChunk);
+		file.read(reinterpret_cast<char*>(chunk.data()), sizeof(FileEntry) * count);
+		if (!file) {
+			return false;
+		}
+		for (std::size_t i = 0; i < count; i++) {
+			if (chunk[i].data & validBit) {
+				Slot& slot = slots[indexOf(chunk[i].key)];
+				slot.check.store(chunk[i].key ^ chunk[i].data, std::memory_order_relaxed);
+				slot.data.store(chunk[i].data, std::memory_order_relaxed);
+			}
+		}
+		remaining -= count;
+	}
+	return true;
+}
+
+void TranspositionTable::persist(std::shared_ptr<TranspositionTable> table, const std::string& filename, int intervalSeconds) {
+	Persisted& state = persisted();
+	if (state.table) {
+		return;
+	}
+	state.table = std::move(table);
+	state.filename = filename;
+	std::atexit(saveAtExit);
+	state.thread = std::thread([&state, intervalSeconds] {
+		std::unique_lock<std::mutex> lock(state.mutex);
+		while (!state.stopped.wait_for(lock, std::chrono::seconds(intervalSeconds), [&state] { return state.stopping; })) {
+			state.table->save(state.filename);
+		}
+	});
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry& entry) const {
+	const Slot& slot = slots[indexOf(key)];
+	std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+	std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+	if (!(data & validBit) || (check ^ data) != key) {
+		return false;
+	}
+	entry = unpack(data);
+	return true;
+}
+
+void TranspositionTable::store(std::uint64_t key, const Entry& entry) {
+	Slot& slot = slots[indexOf(key)];
+	std::uint64_t data = pack(entry);
+	slot.check.store(key ^ data, std::memory_order_relaxed);
+	slot.data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,99 @@
+#ifndef TRANSPOSITION_HPP
+#define TRANSPOSITION_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+* @brief a fixed-size cache of search results keyed by a 64 bit position key
+* The table is either private to the process or lives in a named shared-memory segment that any number
+* of engine processes on the host attach to. Entries are written without locks: each slot stores its data
+* next to key ^ data, so a reader that sees a slot torn by a concurrent writer just misses.
+*/
+class TranspositionTable {
+	public:
+		enum Bound : std::uint8_t {
+			exact,
+			lowerBound,
+			upperBound,
+		};
+		struct Entry {
+			int score;
+			Bound bound;
+			int depth;
+			int bestSquare;
+		};
+		/**
+		* @brief bumped whenever the meaning of stored scores changes, processes built with another version refuse to attach
+		* The headers store it combined with a hash of evaluation_weights.hpp, so rerunning --tune changes it too.
+		*/
+		static const std::uint32_t engineVersion = 3;
+		/**
+		* @brief creates a table private to this process
+		* @param entryCount, rounded down to a power of two
+		*/
+		explicit TranspositionTable(std::size_t entryCount);
+		~TranspositionTable();
+		TranspositionTable(const TranspositionTable&) = delete;
+		TranspositionTable& operator=(const TranspositionTable&) = delete;
+		/**
+		* @brief attaches to the shared-memory table with the given name, creating it if no process has yet
+		* @return nullptr if shared memory is unavailable or the existing table has another layout or engine version
+		*/
+		static std::unique_ptr<TranspositionTable> attachShared(const std::string& name, std::size_t entryCount);
+		/**
+		* @brief deletes the named shared-memory table, processes still attached keep their mapping
+		*/
+		static void removeShared(const std::string& name);
+		/**
+		* @brief writes every filled slot to a compact file: a header with the format and engine version, then a key and entry each
+		* The file is written beside filename and renamed over it, so a crash while saving keeps the previous file.
+		* Safe to call while other threads are searching, entries torn by a concurrent store are skipped.
+		* @return false if the file could not be written
+		*/
+		bool save(const std::string& filename) const;
+		/**
+		* @brief adds the entries of a file written by save() to the table, which need not be the size it was saved from
+		* @return false if the file is missing, damaged or written by another format or engine version
+		*/
+		bool load(const std::string& filename);
+		/**
+		* @brief saves table to filename every intervalSeconds on a background thread, and once more when the program exits
+		*/
+		static void persist(std::shared_ptr<TranspositionTable> table, const std::string& filename, int intervalSeconds = 60);
+		bool probe(std::uint64_t key, Entry& entry) const;
+		void store(std::uint64_t key, const Entry& entry);
+		std::size_t getEntryCount() const { return entryCount; }
+		bool isShared() const { return shared; }
+	private:
+		struct Header {
+			char magic[8];
+			std::uint32_t formatVersion;
+			std::uint32_t engineVersion;
+			std::uint64_t entryCount;
+			std::atomic<std::uint32_t> ready;
+		};
+		struct Slot {
+			std::atomic<std::uint64_t> check;
+			std::atomic<std::uint64_t> data;
+		};
+		TranspositionTable() = default;
+		static std::size_t mappingSize(std::size_t entryCount);
+		void initialiseHeader();
+		bool hasCompatibleHeader() const;
+		std::size_t indexOf(std::uint64_t key) const;
+		Header* header = nullptr;
+		Slot* slots = nullptr;
+		std::size_t entryCount = 0;
+		bool shared = false;
+		void* mapping = nullptr;
+		std::size_t mappingLength = 0;
+#ifdef _WIN32
+		void* mappingHandle = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <thread>
+#include "engine.hpp"
+#include "evaluation_weights.hpp"
+#include "tuner.hpp"
+
+namespace {
+	// an engine score of this many points is one unit of the sigmoid's input
+	const double scoreScale = 1024.0;
+	// the largest weight written, so that all windows together stay well below LineEvaluator::maxScore
+	const int maxWeight = 1 << 16;
+	const int randomOpeningPlies = 2;
+	// percentage of later moves played at random
+	const int randomMoveChance = 10;
+	const int searchDepth = 1;
+
+	double sigmoid(double x) {
+		return 1.0 / (1.0 + std::exp(-x));
+	}
+}
+
+WeightTuner::WeightTuner(int size, int winLength) : size(size), winLength(winLength), weights(LineEvaluator::featureCount + 1, 0.0) {
+	weights[0] = evaluationWeights::centre / scoreScale;
+	for (int missing = 1; missing < BitBoard::maxSize; missing++) {
+		weights[missing] = evaluationWeights::openWindows[missing] / scoreScale;
+		weights[LineEvaluator::blockedFeatures + missing] = evaluationWeights::blockedWindows[missing] / scoreScale;
+	}
+}
+
+double WeightTuner::generate(long long games, int threadCount, unsigned seed) {
+	if (threadCount < 1) {
+		threadCount = 1;
+	}
+	auto startTime = std::chrono::steady_clock::now();
+
+	std::vector<std::vector<TuningSample>> positions(threadCount);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; i++) {
+		long long share = games / threadCount + (i < games % threadCount ? 1 : 0);
+		threads.emplace_back(&WeightTuner::playGames, this, share, seed * 7919 + static_cast<unsigned>(i), std::ref(positions[i]));
+	}
+	std::size_t before = samples.size();
+	for (int i = 0; i < threadCount; i++) {
+		threads[i].join();
+		samples.insert(samples.end(), positions[i].begin(), positions[i].end());
+	}
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return elapsed > 0 ? (samples.size() - before) / elapsed : 0;
+}
+
+void WeightTuner::playGames(long long games, unsigned seed, std::vector<TuningSample>& positions) const {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> percent(0, 99);
+	Engine engine(0, false);
+	engine.setSearchLimits(searchDepth, 0);
+	int features[LineEvaluator::featureCount];
+
+	for (long long game = 0; game < games; game++) {
+		Board board(size, winLength);
+		LineEvaluator evaluator(board);
+		std::size_t firstPosition = positions.size();
+		char symbol = 'X';
+
+		for (int ply = 0; evaluator.evaluate() == 0 && evaluator.getEmptyCount() > 0; ply++) {
+			int row, col;
+			if (ply < randomOpeningPlies || percent(rng) < randomMoveChance) {
+				// updateBoard() takes square numbers only up to the 3x3 board's, so pick an empty cell directly
+				int skip = std::uniform_int_distribution<int>(0, evaluator.getEmptyCount() - 1)(rng);
+				int cell = -1;
+				do {
+					cell++;
+					if (board.getCell(cell / size, cell % size) == ' ') {
+						skip--;
+					}
+				} while (skip >= 0);
+				row = cell / size;
+				col = cell % size;
+				board.setCell(row, col, symbol);
+			}
+			else {
+				std::pair<int, int> move = engine.findBestMove(board, symbol);
+				row = move.first;
+				col = move.second;
+				board.setCell(row, col, symbol);
+			}
+			evaluator.play(row, col, symbol);
+			symbol = (symbol == 'X') ? 'O' : 'X';
+
+			if (evaluator.evaluate() == 0 && evaluator.getEmptyCount() > 0) {
+				TuningSample sample{};
+				evaluator.getFeatures(features);
+				for (int i = 0; i < LineEvaluator::featureCount; i++) {
+					sample.features[i] = static_cast<std::int16_t>(features[i]);
+				}
+				positions.push_back(sample);
+			}
+		}
+
+		int eval = evaluator.evaluate();
+		float result = eval == 10 ? 1.0f : eval == -10 ? 0.0f : 0.5f;
+		for (std::size_t i = firstPosition; i < positions.size(); i++) {
+			positions[i].result = result;
+		}
+	}
+}
+
+double WeightTuner::lossAndGradient(const std::vector<double>& point, int threadCount, std::vector<double>& gradient) const {
+	std::vector<double> losses(threadCount, 0.0);
+	std::vector<std::vector<double>> gradients(threadCount, std::vector<double>(point.size(), 0.0));
+	std::vector<std::thread> threads;
+	std::size_t share = (samples.size() + threadCount - 1) / threadCount;
+
+	for (int t = 0; t < threadCount; t++) {
+		threads.emplace_back([&, t] {
+			std::size_t end = std::min(samples.size(), (t + 1) * share);
+			double loss = 0.0;
+			std::vector<double>& sums = gradients[t];
+			for (std::size_t i = t * share; i < end; i++) {
+				const TuningSample& sample = samples[i];
+				double x = point[LineEvaluator::featureCount];
+				for (int f = 0; f < LineEvaluator::featureCount; f++) {
+					x += point[f] * sample.features[f];
+				}
+				double predicted = sigmoid(x);
+				double error = predicted - sample.result;
+				loss += error * error;
+				// d(error^2)/dx through the sigmoid
+				double slope = 2.0 * error * predicted * (1.0 - predicted);
+				for (int f = 0; f < LineEvaluator::featureCount; f++) {
+					sums[f] += slope * sample.features[f];
+				}
+				sums[LineEvaluator::featureCount] += slope;
+			}
+			losses[t] = loss;
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	double loss = 0.0;
+	std::fill(gradient.begin(), gradient.end(), 0.0);
+	for (int t = 0; t < threadCount; t++) {
+		loss += losses[t];
+		for (std::size_t f = 0; f < gradient.size(); f++) {
+			gradient[f] += gradients[t][f] / samples.size();
+		}
+	}
+	return loss / samples.size();
+}
+
+std::pair<double, double> WeightTuner::fit(int iterations, int threadCount) {
+	if (threadCount < 1) {
+		threadCount = 1;
+	}
+	if (samples.empty()) {
+		return { 0.0, 0.0 };
+	}
+
+	// Adam, the features differ too much in scale for one step size to suit them all
+	const double learningRate = 0.002, beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+	std::vector<double> gradient(weights.size()), momentum(weights.size(), 0.0), velocity(weights.size(), 0.0);
+	double initialLoss = lossAndGradient(weights, threadCount, gradient);
+	double loss = initialLoss;
+
+	for (int step = 1; step <= iterations; step++) {
+		for (std::size_t f = 0; f < weights.size(); f++) {
+			momentum[f] = beta1 * momentum[f] + (1 - beta1) * gradient[f];
+			velocity[f] = beta2 * velocity[f] + (1 - beta2) * gradient[f] * gradient[f];
+			double corrected = momentum[f] / (1 - std::pow(beta1, step));
+			weights[f] -= learningRate * corrected / (std::sqrt(velocity[f] / (1 - std::pow(beta2, step))) + epsilon);
+		}
+		loss = lossAndGradient(weights, threadCount, gradient);
+	}
+	return { initialLoss, loss };
+}
+
+bool WeightTuner::writeHeader(const std::string& filename) const {
+	std::ofstream file(filename);
+	if (!file) {
+		return false;
+	}
+	auto toWeight = [](double weight) {
+		return static_cast<int>(std::clamp<double>(std::round(weight * scoreScale), -maxWeight, maxWeight));
+	};
+
+	file << "#ifndef EVALUATION_WEIGHTS_HPP\n"
+		<< "#define EVALUATION_WEIGHTS_HPP\n\n"
+		<< "// written by tic-tac-toe --tune, run it again rather than editing the numbers by hand\n\n"
+		<< "/**\n"
+		<< "* @brief weights of the LineEvaluator terms, fitted to the results of self-play games\n"
+		<< "*/\n"
+		<< "namespace evaluationWeights {\n"
+		<< "\t// weight of each window through a stone, which favours the centre\n"
+		<< "\tconstexpr int centre = " << toWeight(weights[0]) << ";\n"
+		<< "\t// weight of a window holding stones of only one side, by the number of stones it still needs, index 0 unused\n"
+		<< "\tconstexpr int openWindows[" << BitBoard::maxSize << "] = { 0";
+	for (int missing = 1; missing < BitBoard::maxSize; missing++) {
+		// a window needing more stones than the tuning board's lines hold never came up, so it keeps its weight
+		int weight = missing < winLength ? toWeight(weights[missing]) : evaluationWeights::openWindows[missing];
+		file << ", " << weight;
+	}
+	file << " };\n"
+		<< "\t// the same for a window with the other side's stone or the edge of the board just past one of its ends\n"
+		<< "\tconstexpr int blockedWindows[" << BitBoard::maxSize << "] = { 0";
+	for (int missing = 1; missing < BitBoard::maxSize; missing++) {
+		int feature = LineEvaluator::blockedFeatures + missing;
+		int weight = missing < winLength ? toWeight(weights[feature]) : evaluationWeights::blockedWindows[missing];
+		file << ", " << weight;
+	}
+	file << " };\n"
+		<< "\t// the position set and fit these weights came from\n"
+		<< "\tconstexpr const char* source = \"" << samples.size() << " positions from " << size << "x" << size << " with "
+		<< winLength << " in a row\";\n"
+		<< "}\n\n"
+		<< "#endif\n";
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,54 @@
+#ifndef TUNER_HPP
+#define TUNER_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "evaluator.hpp"
+
+/**
+* @brief a self-play position as the LineEvaluator sees it, and how its game ended
+*/
+struct TuningSample {
+	std::array<std::int16_t, LineEvaluator::featureCount> features;
+	// 1 if O won the game, 0 if X won, 0.5 for a draw
+	float result;
+};
+
+/**
+* @brief fits the LineEvaluator weights to the results of self-play games, Texel style
+* Positions come from depth-limited Engine games played on every thread, with a few random moves so the games
+* differ. The fit is gradient descent on the mean squared error between each result and the sigmoid of the
+* position's score, over the whole position set in memory. Every thread sums the loss and gradient of its share.
+*/
+class WeightTuner {
+	public:
+		WeightTuner(int size, int winLength);
+		/**
+		* @brief plays games split over threadCount threads and keeps every unfinished position they reach
+		* @return positions generated per second
+		*/
+		double generate(long long games, int threadCount, unsigned seed = 1);
+		/**
+		* @brief runs iterations steps of gradient descent, starting from the weights the engine uses now
+		* @return the loss before the first step and after the last
+		*/
+		std::pair<double, double> fit(int iterations, int threadCount);
+		/**
+		* @brief writes the fitted weights as a replacement for evaluation_weights.hpp
+		* @return false if the file could not be written
+		*/
+		bool writeHeader(const std::string& filename) const;
+		std::size_t getSampleCount() const { return samples.size(); }
+	private:
+		void playGames(long long games, unsigned seed, std::vector<TuningSample>& positions) const;
+		double lossAndGradient(const std::vector<double>& point, int threadCount, std::vector<double>& gradient) const;
+		int size;
+		int winLength;
+		std::vector<TuningSample> samples;
+		// one weight per feature in units of the sigmoid's input, then the advantage of moving first
+		std::vector<double> weights;
+};
+
+#endif
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "engine.hpp"
+#include "evaluation_weights.hpp"
+#include "renderer.hpp"
+#include "unbounded.hpp"
+
+namespace {
+	const std::size_t initialSlots = 64;
+	const int initialShift = 64 - 6;
+	const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+	// rating of a move that completes a line, and of one that stops the other side completing one
+	const int winningRating = 1 << 30;
+	const int blockingRating = 1 << 29;
+	// a game no one has won after this many stones is called a tie
+	const int maxStones = 400;
+	const int moveTime = 500;
+	const int selfPlayMoveTime = 100;
+	// where O answers X's first stone at the origin, one game after another
+	const int openings[8][2] = { { 0, 1 }, { 1, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 }, { -1, 2 }, { 2, 1 }, { 1, -1 } };
+	// a segment holds every window through its middle cell and the cell past each end of them
+	const int maxSegmentLength = 2 * SparseBoard::maxWinLength + 3;
+
+	/**
+	* @return the stones of symbol in a row through the middle of segment, counting the middle as one of them
+	*/
+	int runLength(const char* segment, int winLength, char symbol) {
+		int middle = winLength + 1;
+		int run = 1;
+		for (int i = middle - 1; i >= 0 && segment[i] == symbol; i--) {
+			run++;
+		}
+		for (int i = middle + 1; i < 2 * winLength + 3 && segment[i] == symbol; i++) {
+			run++;
+		}
+		return run;
+	}
+
+	std::string moveName(std::pair<int, int> move) {
+		return std::to_string(move.first) + "," + std::to_string(move.second);
+	}
+}
+
+CellMap::CellMap() : slots(initialSlots, Slot{ 0, 0 }), shift(initialShift) {}
+
+std::uint64_t CellMap::keyOf(int row, int col) {
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32) | static_cast<std::uint32_t>(col);
+}
+
+std::size_t CellMap::slotOf(std::uint64_t key) const {
+	// Fibonacci hashing, neighbouring cells differ in a few low bits of the key and still land far apart
+	return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+
+int CellMap::get(int row, int col) const {
+	std::uint64_t key = keyOf(row, col);
+	std::size_t mask = slots.size() - 1;
+	for (std::size_t i = slotOf(key); slots[i].value != 0; i = (i + 1) & mask) {
+		if (slots[i].key == key) {
+			return slots[i].value;
+		}
+	}
+	return 0;
+}
+
+void CellMap::set(int row, int col, int value) {
+	std::uint64_t key = keyOf(row, col);
+	std::size_t mask = slots.size() - 1;
+	std::size_t i = slotOf(key);
+	while (slots[i].value != 0 && slots[i].key != key) {
+		i = (i + 1) & mask;
+	}
+
+	if (slots[i].value == 0) {
+		if (value != 0) {
+			slots[i] = { key, value };
+			if (++count * 2 > slots.size()) {
+				grow();
+			}
+		}
+		return;
+	}
+	if (value != 0) {
+		slots[i].value = value;
+		return;
+	}
+
+	// move back every later slot of the run that may sit in the hole, so no lookup stops short of its cell
+	count--;
+	std::size_t hole = i;
+	for (std::size_t j = (hole + 1) & mask; slots[j].value != 0; j = (j + 1) & mask) {
+		std::size_t home = slotOf(slots[j].key);
+		if (((j - home) & mask) >= ((j - hole) & mask)) {
+			slots[hole] = slots[j];
+			hole = j;
+		}
+	}
+	slots[hole].value = 0;
+}
+
+void CellMap::grow() {
+	std::vector<Slot> old(slots.size() * 2, Slot{ 0, 0 });
+	old.swap(slots);
+	shift--;
+	count = 0;
+	for (const Slot& slot : old) {
+		if (slot.value != 0) {
+			set(static_cast<std::int32_t>(slot.key >> 32), static_cast<std::int32_t>(slot.key & 0xFFFFFFFF), slot.value);
+		}
+	}
+}
+
+SparseBoard::SparseBoard(int winLength) : winLength(winLength), weights(winLength + 1, 0), blockedWeights(winLength + 1, 0) {
+	// a complete window is a win, which evaluate() reports, so it adds nothing to the score
+	for (int stones = 1; stones < winLength; stones++) {
+		weights[stones] = evaluationWeights::openWindows[winLength - stones];
+		blockedWeights[stones] = evaluationWeights::blockedWindows[winLength - stones];
+	}
+}
+
+char SparseBoard::getCell(int row, int col) const {
+	int stone = stones.get(row, col);
+	return stone == 0 ? ' ' : static_cast<char>(stone);
+}
+
+bool SparseBoard::play(int row, int col, char symbol) {
+	if (stones.get(row, col) != 0) {
+		return false;
+	}
+
+	char segment[maxSegmentLength];
+	for (int direction = 0; direction < 4; direction++) {
+		readSegment(row, col, direction, segment);
+		score += scoreChange(segment, symbol);
+		if (runLength(segment, winLength, symbol) >= winLength) {
+			winner = symbol;
+		}
+	}
+	stones.set(row, col, symbol);
+
+	for (int dr = -candidateRadius; dr <= candidateRadius; dr++) {
+		for (int dc = -candidateRadius; dc <= candidateRadius; dc++) {
+			neighbours.set(row + dr, col + dc, neighbours.get(row + dr, col + dc) + 1);
+		}
+	}
+	return true;
+}
+
+void SparseBoard::undo(int row, int col) {
+	char symbol = getCell(row, col);
+	stones.set(row, col, 0);
+
+	// with the stone gone the segments read as they did before it was played
+	char segment[maxSegmentLength];
+	for (int direction = 0; direction < 4; direction++) {
+		readSegment(row, col, direction, segment);
+		score -= scoreChange(segment, symbol);
+	}
+	// nothing is played after a win, so the winning stone is always the one taken back
+	winner = ' ';
+
+	for (int dr = -candidateRadius; dr <= candidateRadius; dr++) {
+		for (int dc = -candidateRadius; dc <= candidateRadius; dc++) {
+			neighbours.set(row + dr, col + dc, neighbours.get(row + dr, col + dc) - 1);
+		}
+	}
+}
+
+bool SparseBoard::isWinningMove(int row, int col) const {
+	char symbol = getCell(row, col);
+	if (symbol == ' ') {
+		return false;
+	}
+	char segment[maxSegmentLength];
+	for (int direction = 0; direction < 4; direction++) {
+		readSegment(row, col, direction, segment);
+		if (runLength(segment, winLength, symbol) >= winLength) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int SparseBoard::rateMove(int row, int col, char symbol) const {
+	char other = (symbol == 'X') ? 'O' : 'X';
+	char segment[maxSegmentLength];
+	int mine = 0;
+	int theirs = 0;
+	bool blocks = false;
+	for (int direction = 0; direction < 4; direction++) {
+		readSegment(row, col, direction, segment);
+		if (runLength(segment, winLength, symbol) >= winLength) {
+			return winningRating;
+		}
+		blocks = blocks || runLength(segment, winLength, other) >= winLength;
+		mine += scoreChange(segment, symbol);
+		theirs += scoreChange(segment, other);
+	}
+	return blocks ? blockingRating : std::abs(mine) + std::abs(theirs);
+}
+
+void SparseBoard::generateMoves(std::vector<std::pair<int, int>>& moves) const {
+	moves.clear();
+	neighbours.forEach([&](int row, int col, int) {
+		if (stones.get(row, col) == 0) {
+			moves.push_back({ row, col });
+		}
+	});
+	if (stones.getCount() == 0) {
+		moves.push_back({ 0, 0 });
+	}
+}
+
+void SparseBoard::getBounds(int& minRow, int& maxRow, int& minCol, int& maxCol) const {
+	bool first = true;
+	minRow = maxRow = minCol = maxCol = 0;
+	stones.forEach([&](int row, int col, int) {
+		minRow = first || row < minRow ? row : minRow;
+		maxRow = first || row > maxRow ? row : maxRow;
+		minCol = first || col < minCol ? col : minCol;
+		maxCol = first || col > maxCol ? col : maxCol;
+		first = false;
+	});
+}
+
+void SparseBoard::readSegment(int row, int col, int direction, char* segment) const {
+	for (int i = 0; i < 2 * winLength + 3; i++) {
+		int offset = i - (winLength + 1);
+		segment[i] = getCell(row + directions[direction][0] * offset, col + directions[direction][1] * offset);
+	}
+}
+
+int SparseBoard::scoreChange(const char* segment, char symbol) const {
+	char cells[maxSegmentLength];
+	std::copy(segment, segment + 2 * winLength + 3, cells);
+	// the windows from the one ending just before the middle to the one starting just after it
+	int change = 0;
+	for (int start = 1; start <= winLength + 2; start++) {
+		change -= windowValue(cells + start);
+	}
+	cells[winLength + 1] = symbol;
+	for (int start = 1; start <= winLength + 2; start++) {
+		change += windowValue(cells + start);
+	}
+	return change;
+}
+
+int SparseBoard::windowValue(const char* window) const {
+	int xCount = 0;
+	int oCount = 0;
+	for (int i = 0; i < winLength; i++) {
+		xCount += window[i] == 'X';
+		oCount += window[i] == 'O';
+	}
+	if (xCount > 0 && oCount > 0) {
+		return 0;
+	}
+	if (oCount > 0) {
+		return window[-1] == 'X' || window[winLength] == 'X' ? blockedWeights[oCount] : weights[oCount];
+	}
+	if (xCount > 0) {
+		return window[-1] == 'O' || window[winLength] == 'O' ? -blockedWeights[xCount] : -weights[xCount];
+	}
+	return 0;
+}
+
+void playUnbounded(Renderer& renderer, int winLength, bool computerStarts) {
+	SparseBoard board(winLength);
+	Engine engine(0, false);
+	engine.setSearchLimits(0, moveTime);
+	char symbol = computerStarts ? 'O' : 'X';
+	std::string statusMessage = "Get " + std::to_string(winLength) + " in a row, the board goes on forever.";
+	std::string errorMessage;
+	char winner = ' ';
+
+	while (winner == ' ') {
+		if (symbol == 'O') {
+			auto startTime = std::chrono::steady_clock::now();
+			SearchResult result = engine.search(board, 'O');
+			long elapsed = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+			board.play(result.move.first, result.move.second, 'O');
+			statusMessage = "Computer played " + moveName(result.move) + " (" + std::to_string(result.nodes) + " nodes, "
+				+ std::to_string(elapsed) + " ms)";
+			winner = board.evaluate() != 0 ? 'O' : board.getStoneCount() >= maxStones ? 'T' : ' ';
+			symbol = 'X';
+			continue;
+		}
+
+		std::string promptMessage = "Your move (X), enter row,column (e.g. 0,-2): ";
+		renderer.clearScreen();
+		renderer.renderUnboundedScreen(board, statusMessage, promptMessage + "\n" + errorMessage);
+		std::string input = renderer.prompt(static_cast<int>(promptMessage.length()));
+		if (!std::cin) {
+			return;
+		}
+
+		std::istringstream stream(input);
+		int row, col;
+		char comma;
+		bool valid = stream >> row >> comma >> col && comma == ',' && stream.peek() == EOF;
+		if (!valid || !board.play(row, col, 'X')) {
+			errorMessage = valid ? "That cell is already taken." : "Enter a row and a column, any whole numbers, with a comma between them.";
+			continue;
+		}
+		errorMessage = "";
+		winner = board.evaluate() != 0 ? 'X' : board.getStoneCount() >= maxStones ? 'T' : ' ';
+		symbol = 'O';
+	}
+
+	renderer.clearScreen();
+	renderer.renderUnboundedScreen(board, statusMessage, winner == 'T' ? "It's a tie!" : std::string("Player ") + winner + " wins!");
+}
+
+void runUnboundedSelfPlay(int winLength, int games) {
+	for (int game = 0; game < games; game++) {
+		SparseBoard board(winLength);
+		Engine engine(0, false);
+		engine.setSearchLimits(0, selfPlayMoveTime);
+		char winner = 'T';
+		std::uint64_t nodes = 0;
+		double searchSeconds = 0;
+
+		// O's first stone goes somewhere different in every game so the games are not all the same
+		board.play(0, 0, 'X');
+		board.play(openings[game % 8][0], openings[game % 8][1], 'O');
+		char symbol = 'X';
+
+		while (board.getStoneCount() < maxStones) {
+			auto startTime = std::chrono::steady_clock::now();
+			SearchResult result = engine.search(board, symbol);
+			searchSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+			nodes += result.nodes;
+
+			board.play(result.move.first, result.move.second, symbol);
+			if (board.getStoneCount() % 20 == 0) {
+				std::cout << "  " << board.getStoneCount() << " stones: " << static_cast<long long>(nodes / searchSeconds)
+					<< " nodes/s, board " << board.getMemoryUsage() << " bytes" << std::endl;
+			}
+			if (board.evaluate() != 0) {
+				winner = symbol;
+				break;
+			}
+			symbol = (symbol == 'X') ? 'O' : 'X';
+		}
+
+		int minRow, maxRow, minCol, maxCol;
+		board.getBounds(minRow, maxRow, minCol, maxCol);
+		std::cout << "game " << game + 1 << ": " << (winner == 'T' ? std::string("tie") : std::string(1, winner) + " wins")
+			<< " after " << board.getStoneCount() << " stones on " << maxRow - minRow + 1 << "x" << maxCol - minCol + 1
+			<< " cells, " << static_cast<long long>(nodes / searchSeconds) << " nodes/s, board "
+			<< board.getMemoryUsage() << " bytes" << std::endl;
+	}
+}
@@ -0,0 +1,142 @@
+#ifndef UNBOUNDED_HPP
+#define UNBOUNDED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+* @brief open-addressing hash map from a cell to a small non-zero value, a missing cell reads as 0
+* Row and column are packed into one 64 bit key, so any int coordinates fit. Linear probing over a power of two
+* slot array that doubles at half full, and erasing shifts the following slots back instead of leaving markers,
+* so lookups stay short however many cells come and go.
+*/
+class CellMap {
+	public:
+		CellMap();
+		int get(int row, int col) const;
+		/**
+		* @param value, 0 removes the cell
+		*/
+		void set(int row, int col, int value);
+		std::size_t getCount() const { return count; }
+		std::size_t getMemoryUsage() const { return slots.capacity() * sizeof(Slot); }
+		/**
+		* @brief calls visit(row, col, value) for every cell in the map, in no particular order
+		*/
+		template <typename Visit>
+		void forEach(Visit visit) const {
+			for (const Slot& slot : slots) {
+				if (slot.value != 0) {
+					visit(static_cast<std::int32_t>(slot.key >> 32), static_cast<std::int32_t>(slot.key & 0xFFFFFFFF), slot.value);
+				}
+			}
+		}
+	private:
+		struct Slot {
+			std::uint64_t key;
+			std::int32_t value;
+		};
+		static std::uint64_t keyOf(int row, int col);
+		std::size_t slotOf(std::uint64_t key) const;
+		void grow();
+		std::vector<Slot> slots;
+		std::size_t count = 0;
+		int shift;
+};
+
+/**
+* @brief k in a row on a board with no edges, holding only the stones played
+* Stones live in a CellMap, and a second map counts the stones near every cell, so the candidate moves
+* are read off that map instead of a scan of the board. Playing a stone reads the line segments through its cell,
+* which is enough to find a win and to update the score of the windows through or next to it. Memory and the cost of a move grow
+* with the number of stones, never with the area they cover.
+*/
+class SparseBoard {
+	public:
+		/**
+		* @param winLength, stones in a row that win, up to maxWinLength
+		*/
+		explicit SparseBoard(int winLength = 5);
+		/**
+		* @return 'X', 'O' or ' '
+		*/
+		char getCell(int row, int col) const;
+		/**
+		* @return false if the cell is taken
+		*/
+		bool play(int row, int col, char symbol);
+		/**
+		* @brief takes back the stone at row, col, which must be the last one played
+		*/
+		void undo(int row, int col);
+		/**
+		* @brief checks only the lines through the cell, as far as winLength - 1 cells each way
+		*/
+		bool isWinningMove(int row, int col) const;
+		/**
+		* @return 10 if O has won, -10 if X has won, 0 otherwise, like Board::evaluate()
+		*/
+		int evaluate() const { return winner == 'O' ? 10 : winner == 'X' ? -10 : 0; }
+		/**
+		* @return sum of the open and blocked windows weighted by evaluation_weights.hpp, positive is good for O
+		* The board has no edges, so only a stone of the other side just past its end blocks a window.
+		*/
+		int getScore() const { return score; }
+		/**
+		* @brief how much the score would change if symbol played at row, col, and if the other side did
+		* The sum of the two sizes ranks a move by what it builds and what it blocks.
+		*/
+		int rateMove(int row, int col, char symbol) const;
+		/**
+		* @brief the empty cells within candidateRadius of a stone, or the origin on an empty board
+		*/
+		void generateMoves(std::vector<std::pair<int, int>>& moves) const;
+		int getStoneCount() const { return static_cast<int>(stones.getCount()); }
+		int getWinLength() const { return winLength; }
+		/**
+		* @return bytes held by the board's maps
+		*/
+		std::size_t getMemoryUsage() const { return stones.getMemoryUsage() + neighbours.getMemoryUsage(); }
+		/**
+		* @brief the smallest rectangle holding every stone, all 0 on an empty board
+		*/
+		void getBounds(int& minRow, int& maxRow, int& minCol, int& maxCol) const;
+		static const int maxWinLength = 15;
+		static const int candidateRadius = 2;
+	private:
+		/**
+		* @brief reads the cells from winLength + 1 before row, col to winLength + 1 after it in one direction
+		*/
+		void readSegment(int row, int col, int direction, char* segment) const;
+		/**
+		* @return the change to the score of the windows through or just past the middle of segment if symbol is put there
+		*/
+		int scoreChange(const char* segment, char symbol) const;
+		/**
+		* @param window, the first of winLength cells, the cells just before and after them are read too
+		*/
+		int windowValue(const char* window) const;
+		int winLength;
+		CellMap stones;
+		// for every cell near a stone, how many stones are within candidateRadius of it
+		CellMap neighbours;
+		int score = 0;
+		char winner = ' ';
+		std::vector<int> weights;
+		std::vector<int> blockedWeights;
+};
+
+class Renderer;
+
+/**
+* @brief plays k in a row on the unbounded board in the terminal, the human is X and types moves as row,column
+*/
+void playUnbounded(Renderer& renderer, int winLength, bool computerStarts);
+/**
+* @brief plays the engine against itself and reports moves, nodes per second and board memory as the stones add up
+*/
+void runUnboundedSelfPlay(int winLength, int games);
+
+#endif
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <fstream>
+#include "allocations.hpp"
 #include "utils.hpp"
 
 namespace utils {
@@ -23,6 +24,7 @@ namespace utils {
     }
 
     void log(const std::string& filename, const std::string& text, bool newLine = true) {
+        allocations::ScopeGuard logScope(allocations::log);
         std::ofstream log_file(filename, std::ios::app);
 
         if (!log_file) {